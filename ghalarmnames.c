@@ -0,0 +1,9 @@
+/**  @brief Alarm names, indexed by alarm code
+ *   @file ghalarmnames.c
+ */
+#include "ghalarmnames.h"
+
+const char alarmnames[NALARMS][ALARMNMSZ] = {
+    "No Alarms", "High Temperature", "Low Temperature", "High Humidity",
+    "Low Humidity", "High Pressure", "Low Pressure", "Temperature Rate",
+    "Humidity Rate", "Pressure Rate"};
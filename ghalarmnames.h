@@ -0,0 +1,15 @@
+/**  @brief Alarm name constants and table, shared by the controller and the
+ * journal tools
+ *   @file ghalarmnames.h
+ */
+#ifndef GHALARMNAMES_H
+#define GHALARMNAMES_H
+
+#define NALARMS 10
+#define ALARMNMSZ 18
+
+///@cond INTERNAL
+extern const char alarmnames[NALARMS][ALARMNMSZ];
+///@endcond
+
+#endif
@@ -0,0 +1,80 @@
+/**  @brief List alarm raise and clear events recorded in the alarm journal
+ *   @file ghalarms.c
+ */
+#include "ghalarmnames.h"
+#include "ghjournal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define QUERYMAX 4096
+#define TIMESTRSZ 26 // ctime_r buffer
+
+/**  @brief Parse a "YYYY-MM-DD[ HH:MM:SS]" local date.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param s date text.
+ *   @param t receives the time.
+ *   @return 1 if the date was understood.
+ */
+static int GhAlarmsParseDate(const char *s, time_t *t)
+{
+  struct tm tm = {0};
+  if (sscanf(s, "%d-%d-%d %d:%d:%d", &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+             &tm.tm_hour, &tm.tm_min, &tm.tm_sec) < 3)
+  {
+    return 0;
+  }
+  tm.tm_year -= 1900;
+  tm.tm_mon -= 1;
+  tm.tm_isdst = -1;
+  *t = mktime(&tm);
+  return 1;
+}
+
+int main(int argc, char *argv[])
+{
+  static alarmevent_s events[QUERYMAX];
+  const char *fname = GHJOURNALFILE;
+  time_t from = 0, to = time(NULL) + 1;
+  char tbuf[TIMESTRSZ];
+  int opt, i, n, done = 0;
+
+  while ((opt = getopt(argc, argv, "s:e:")) != -1)
+  {
+    if ((opt != 's' && opt != 'e') ||
+        !GhAlarmsParseDate(optarg, opt == 's' ? &from : &to))
+    {
+      fprintf(stderr, "usage: %s [-s start] [-e end] [journal]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind < argc)
+  {
+    fname = argv[optind];
+  }
+  if (!GhJournalAttach(fname))
+  {
+    fprintf(stderr, "%s: no alarm journal\n", fname);
+    return EXIT_FAILURE;
+  }
+  // Pages follow one another by position in the window, so events sharing a
+  // second with a page boundary are neither skipped nor repeated
+  do
+  {
+    n = GhJournalQuery(from, to, done, events, QUERYMAX);
+    for (i = 0; i < n; i++)
+    {
+      time_t etime = (time_t)events[i].etime;
+      int code = events[i].code;
+      printf("%.24s %-6s %-18s %7.1lf\n", ctime_r(&etime, tbuf),
+             events[i].type == ALARMRAISE ? "raise" : "clear",
+             code >= 0 && code < NALARMS ? alarmnames[code] : "Unknown",
+             events[i].value);
+    }
+    done += n;
+  } while (n == QUERYMAX);
+  GhJournalClose();
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,752 @@
+/**  @brief Code for exporting readings as Apache Arrow IPC files. The
+ * flatbuffer metadata is laid out by hand, so no Arrow or flatbuffers library
+ * is needed. A rolling export rewrites the footer after every record batch so
+ * the file can be memory mapped by analytics tools while it grows, a one off
+ * export writes it once when closed
+ *   @file gharrow.c
+ */
+#include "gharrow.h"
+#include <dirent.h>
+#include <libgen.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define ARROWMAGIC "ARROW1"
+#define ARROWCONTINUE 0xFFFFFFFFu // starts every encapsulated message
+#define ARROWMETASZ 2048          // room for the metadata of one message
+#define ARROWV5 4                 // MetadataVersion V5
+#define ARROWSCHEMA 1             // MessageHeader union members
+#define ARROWRECORDBATCH 3
+#define ARROWINT 2                // Type union members
+#define ARROWFLOAT 3
+#define ARROWBOOL 6
+#define ARROWTIMESTAMP 10
+#define ARROWDOUBLE 2             // FloatingPoint precision
+#define ARROWSECOND 0             // Timestamp unit
+
+// Flatbuffer being laid out front to back. Every offset points forward,
+// so a table is always written before the strings, vectors and tables it
+// refers to. Multi-byte values are stored in host order, which is little
+// endian on the Pi.
+typedef struct flatbuf
+{
+  uint8_t *buf;
+  size_t cap;
+  size_t len;
+  int overflow;
+} flatbuf_s;
+
+typedef struct arrowcolumn
+{
+  const char *name;
+  int type;     // Type union member
+  int bits;     // width of one value
+  int nullable;
+} arrowcolumn_s;
+
+static const arrowcolumn_s columns[ARROWCOLUMNS] = {
+    {"time", ARROWTIMESTAMP, 64, 0},    {"unit", ARROWINT, 64, 0},
+    {"temperature", ARROWFLOAT, 64, 1}, {"humidity", ARROWFLOAT, 64, 1},
+    {"pressure", ARROWFLOAT, 64, 1},    {"heater", ARROWBOOL, 1, 1},
+    {"humidifier", ARROWBOOL, 1, 1},    {"alarms", ARROWINT, 32, 1}};
+
+static int arrowfd = -1;              // Export file handle
+static char arrowname[ARROWNAMESZ];   // Export file name
+static char segdir[ARROWNAMESZ];      // Directory of the export file
+static char segprefix[ARROWNAMESZ];   // "ghreadings-" for ghreadings.arrow
+static int arrowroll = 0;             // Set if full files are rolled
+static int batchrows = ARROWROWS;     // Rows per record batch
+static int nrows = 0;                 // Rows waiting in the batch
+static int nulls[ARROWCOLUMNS];       // Null count of each column
+static uint8_t valid[ARROWCOLUMNS][ARROWBATCHMAX / 8];
+static uint8_t data[ARROWCOLUMNS][ARROWBATCHMAX * 8];
+static uint8_t message[8 + ARROWMETASZ +
+                       ARROWCOLUMNS * (ARROWBATCHMAX / 8 + ARROWBATCHMAX * 8)];
+// A rolled file never holds more than ARROWROLLBATCHES batches, so a rolling
+// export lists its blocks and builds its footer in static memory. Only a one
+// off export can outgrow them onto the heap.
+static arrowblock_s rollblocks[ARROWROLLBATCHES];
+static uint8_t rollfooter[ARROWMETASZ +
+                          ARROWROLLBATCHES * sizeof(arrowblock_s)];
+static arrowblock_s *blocks = rollblocks; // Record batches in the file
+static int nblocks = 0, blockcap = ARROWROLLBATCHES;
+static uint8_t *footer = rollfooter;      // End of stream, footer and trailer
+static size_t footcap = sizeof(rollfooter);
+static char retained[ARROWRETAIN][NAME_MAX + 1]; // Newest rolled file names
+static int64_t dataend = 0;           // Where the next batch is written
+
+/**  @brief Grow a buffer that starts out as a static array onto the heap.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cur current buffer.
+ *   @param fixed static array the buffer starts out as.
+ *   @param used bytes of cur to keep.
+ *   @param size bytes needed.
+ *   @return the grown buffer, NULL if out of memory.
+ */
+static void *GhArrowGrow(void *cur, void *fixed, size_t used, size_t size)
+{
+  void *p = cur == fixed ? malloc(size) : realloc(cur, size);
+
+  if (p != NULL && cur == fixed)
+  {
+    memcpy(p, cur, used);
+  }
+  return p;
+}
+
+/**  @brief Make room in a flatbuffer, zero filled.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param size bytes needed.
+ *   @param align alignment of the first byte from the buffer start.
+ *   @return position of the room.
+ */
+static size_t GhArrowReserve(flatbuf_s *fb, size_t size, size_t align)
+{
+  size_t pos = (fb->len + align - 1) / align * align;
+
+  if (pos + size > fb->cap)
+  {
+    fb->overflow = 1;
+    return 0;
+  }
+  memset(fb->buf + fb->len, 0, pos + size - fb->len);
+  fb->len = pos + size;
+  return pos;
+}
+
+/**  @brief Store bytes at a reserved position of a flatbuffer.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param pos position returned by GhArrowReserve.
+ *   @param v bytes to store.
+ *   @param size number of bytes.
+ *   @return void
+ */
+static void GhArrowPut(flatbuf_s *fb, size_t pos, const void *v, size_t size)
+{
+  if (!fb->overflow)
+  {
+    memcpy(fb->buf + pos, v, size);
+  }
+}
+
+/**  @brief Point an offset field at an object written after it.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param at position of the offset field.
+ *   @param target position of the object.
+ *   @return void
+ */
+static void GhArrowLink(flatbuf_s *fb, size_t at, size_t target)
+{
+  uint32_t off = target - at;
+  GhArrowPut(fb, at, &off, sizeof(off));
+}
+
+/**  @brief Lay out a table with its vtable in front of it. Fields are
+ * aligned to their own size.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param n number of fields in the schema of the table, at most 8.
+ *   @param size size of each field, 0 for a field left at its default.
+ *   @param pos receives the position of each field.
+ *   @return position of the table.
+ */
+static size_t GhArrowTable(flatbuf_s *fb, int n, const int size[], size_t pos[])
+{
+  uint16_t vtable[2 + 8];
+  size_t vpos, tpos;
+  int32_t soff;
+  int i;
+
+  vpos = GhArrowReserve(fb, 4 + 2 * n, 2);
+  tpos = GhArrowReserve(fb, 4, 4);
+  for (i = 0; i < n; i++)
+  {
+    pos[i] = size[i] > 0 ? GhArrowReserve(fb, size[i], size[i]) : 0;
+  }
+  vtable[0] = 4 + 2 * n;
+  vtable[1] = fb->len - tpos;
+  for (i = 0; i < n; i++)
+  {
+    vtable[2 + i] = pos[i] > 0 ? pos[i] - tpos : 0;
+  }
+  GhArrowPut(fb, vpos, vtable, 4 + 2 * n);
+  soff = tpos - vpos;
+  GhArrowPut(fb, tpos, &soff, sizeof(soff));
+  return tpos;
+}
+
+/**  @brief Lay out a string.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param s string to store.
+ *   @return position of the string.
+ */
+static size_t GhArrowString(flatbuf_s *fb, const char *s)
+{
+  uint32_t n = strlen(s);
+  size_t pos = GhArrowReserve(fb, 4 + n + 1, 4);
+
+  GhArrowPut(fb, pos, &n, sizeof(n));
+  GhArrowPut(fb, pos + 4, s, n);
+  return pos;
+}
+
+/**  @brief Lay out a vector. The elements, not the length before them, carry
+ * the alignment.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @param n number of elements.
+ *   @param elem size of one element.
+ *   @param align alignment of the elements, 4 or 8.
+ *   @return position of the vector, the elements start 4 bytes later.
+ */
+static size_t GhArrowVector(flatbuf_s *fb, uint32_t n, size_t elem,
+                            size_t align)
+{
+  size_t pos;
+
+  GhArrowReserve(fb, (align - (fb->len + 4) % align) % align, 1);
+  pos = GhArrowReserve(fb, 4 + n * elem, 4);
+  GhArrowPut(fb, pos, &n, sizeof(n));
+  return pos;
+}
+
+/**  @brief Lay out the Schema table shared by the schema message and the
+ * footer.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer being laid out.
+ *   @return position of the table.
+ */
+static size_t GhArrowSchema(flatbuf_s *fb)
+{
+  static const int ssize[2] = {0, 4};          // endianness left at Little
+  static const int fsize[6] = {4, 1, 1, 4, 0, 4}; // no dictionary
+  static const int isize[2] = {4, 1};
+  static const int psize[1] = {2};
+  size_t spos[2], fpos[6], tpos[2], schema, vec, field, type;
+  int32_t bits;
+  int16_t param;
+  uint8_t b;
+  int c;
+
+  schema = GhArrowTable(fb, 2, ssize, spos);
+  vec = GhArrowVector(fb, ARROWCOLUMNS, 4, 4);
+  GhArrowLink(fb, spos[1], vec);
+  for (c = 0; c < ARROWCOLUMNS; c++)
+  {
+    field = GhArrowTable(fb, 6, fsize, fpos);
+    GhArrowLink(fb, vec + 4 + 4 * c, field);
+    GhArrowLink(fb, fpos[0], GhArrowString(fb, columns[c].name));
+    b = columns[c].nullable;
+    GhArrowPut(fb, fpos[1], &b, 1);
+    b = columns[c].type;
+    GhArrowPut(fb, fpos[2], &b, 1);
+    if (columns[c].type == ARROWINT)
+    {
+      type = GhArrowTable(fb, 2, isize, tpos);
+      bits = columns[c].bits;
+      GhArrowPut(fb, tpos[0], &bits, sizeof(bits)); // unsigned
+    }
+    else if (columns[c].type == ARROWBOOL)
+    {
+      type = GhArrowTable(fb, 0, NULL, tpos);
+    }
+    else
+    {
+      type = GhArrowTable(fb, 1, psize, tpos);
+      param = columns[c].type == ARROWFLOAT ? ARROWDOUBLE : ARROWSECOND;
+      GhArrowPut(fb, tpos[0], &param, sizeof(param));
+    }
+    GhArrowLink(fb, fpos[3], type);
+    GhArrowLink(fb, fpos[5], GhArrowVector(fb, 0, 4, 4));
+  }
+  return schema;
+}
+
+/**  @brief Start the metadata of an encapsulated message in the message
+ * buffer.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb receives the flatbuffer being laid out.
+ *   @param header MessageHeader union member.
+ *   @param bodylength bytes of buffers following the metadata.
+ *   @return position of the header field to link the header table to.
+ */
+static size_t GhArrowMessageBegin(flatbuf_s *fb, int header, int64_t bodylength)
+{
+  static const int msize[4] = {2, 1, 4, 8};
+  size_t root, mpos[4];
+  int16_t version = ARROWV5;
+  uint8_t b = header;
+
+  fb->buf = message + 8;
+  fb->cap = ARROWMETASZ;
+  fb->len = 0;
+  fb->overflow = 0;
+  root = GhArrowReserve(fb, 4, 4);
+  GhArrowLink(fb, root, GhArrowTable(fb, 4, msize, mpos));
+  GhArrowPut(fb, mpos[0], &version, sizeof(version));
+  GhArrowPut(fb, mpos[1], &b, 1);
+  GhArrowPut(fb, mpos[3], &bodylength, sizeof(bodylength));
+  return mpos[2];
+}
+
+/**  @brief Finish a message, adding the continuation marker and metadata size
+ * in front of the flatbuffer.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fb flatbuffer of the message.
+ *   @return bytes of the message before its body, 0 if the metadata overflowed.
+ */
+static size_t GhArrowMessageEnd(flatbuf_s *fb)
+{
+  uint32_t prefix[2] = {ARROWCONTINUE, 0};
+
+  GhArrowReserve(fb, 0, 8);
+  if (fb->overflow)
+  {
+    return 0;
+  }
+  prefix[1] = fb->len;
+  memcpy(message, prefix, sizeof(prefix));
+  return 8 + fb->len;
+}
+
+/**  @brief Rewrite the end of stream marker, footer and trailer after the
+ * last batch, leaving a complete file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the footer was written.
+ */
+static int GhArrowFooter(void)
+{
+  static const int fsize[4] = {2, 4, 4, 4};
+  uint32_t eos[2] = {ARROWCONTINUE, 0};
+  size_t need, root, fpos[4], vec, n;
+  int16_t version = ARROWV5;
+  int32_t flen;
+  flatbuf_s fb;
+  uint8_t *p;
+
+  need = ARROWMETASZ + nblocks * sizeof(arrowblock_s);
+  if (need > footcap)
+  {
+    p = GhArrowGrow(footer, rollfooter, 0, need);
+    if (p == NULL)
+    {
+      return 0;
+    }
+    footer = p;
+    footcap = need;
+  }
+  memcpy(footer, eos, sizeof(eos));
+  fb.buf = footer + sizeof(eos);
+  fb.cap = footcap - sizeof(eos) - 16;
+  fb.len = 0;
+  fb.overflow = 0;
+  root = GhArrowReserve(&fb, 4, 4);
+  GhArrowLink(&fb, root, GhArrowTable(&fb, 4, fsize, fpos));
+  GhArrowPut(&fb, fpos[0], &version, sizeof(version));
+  GhArrowLink(&fb, fpos[1], GhArrowSchema(&fb));
+  GhArrowLink(&fb, fpos[2], GhArrowVector(&fb, 0, sizeof(arrowblock_s), 8));
+  vec = GhArrowVector(&fb, nblocks, sizeof(arrowblock_s), 8);
+  GhArrowLink(&fb, fpos[3], vec);
+  GhArrowPut(&fb, vec + 4, blocks, nblocks * sizeof(arrowblock_s));
+  GhArrowReserve(&fb, 0, 8);
+  if (fb.overflow)
+  {
+    return 0;
+  }
+  flen = fb.len;
+  n = sizeof(eos) + fb.len;
+  memcpy(footer + n, &flen, sizeof(flen));
+  memcpy(footer + n + sizeof(flen), ARROWMAGIC, 6);
+  n += sizeof(flen) + 6;
+  if (pwrite(arrowfd, footer, n, dataend) != (ssize_t)n ||
+      ftruncate(arrowfd, dataend + n) == -1)
+  {
+    perror("Error (call to 'pwrite')");
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Start a new export file holding the schema and an empty footer.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the file was started.
+ */
+static int GhArrowStart(void)
+{
+  flatbuf_s fb;
+  size_t hpos, n;
+
+  arrowfd = open(arrowname, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (arrowfd == -1)
+  {
+    perror("Error (call to 'open')");
+    return 0;
+  }
+  hpos = GhArrowMessageBegin(&fb, ARROWSCHEMA, 0);
+  GhArrowLink(&fb, hpos, GhArrowSchema(&fb));
+  n = GhArrowMessageEnd(&fb);
+  nblocks = 0;
+  dataend = 8 + n;
+  if (n == 0 || pwrite(arrowfd, ARROWMAGIC "\0\0", 8, 0) != 8 ||
+      pwrite(arrowfd, message, n, 8) != (ssize_t)n || !GhArrowFooter())
+  {
+    close(arrowfd);
+    arrowfd = -1;
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Select rolled export files by name.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param de directory entry.
+ *   @return non zero for a rolled export file.
+ */
+static int GhArrowSegment(const struct dirent *de)
+{
+  return strncmp(de->d_name, segprefix, strlen(segprefix)) == 0;
+}
+
+/**  @brief Delete the oldest rolled files beyond ARROWRETAIN. The newest
+ * names are kept in order while the directory is read, and a name dropping
+ * out of them is deleted at once, so any number of files is handled without
+ * allocating.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+static void GhArrowRetain(void)
+{
+  char path[2 * ARROWNAMESZ + 32];
+  struct dirent *de;
+  DIR *dir = opendir(segdir);
+  int n = 0, i;
+
+  if (dir == NULL)
+  {
+    return;
+  }
+  while ((de = readdir(dir)) != NULL)
+  {
+    if (!GhArrowSegment(de))
+    {
+      continue;
+    }
+    // Names sort by the time they were rolled, oldest first
+    for (i = n; i > 0 && strcmp(retained[i - 1], de->d_name) > 0; i--)
+    {
+    }
+    if (n == ARROWRETAIN && i == 0)
+    {
+      snprintf(path, sizeof(path), "%s/%s", segdir, de->d_name);
+      unlink(path);
+      continue;
+    }
+    if (n == ARROWRETAIN)
+    {
+      snprintf(path, sizeof(path), "%s/%s", segdir, retained[0]);
+      unlink(path);
+      memmove(retained[0], retained[1], (size_t)(i - 1) * sizeof(retained[0]));
+      i--;
+    }
+    else
+    {
+      memmove(retained[i + 1], retained[i],
+              (size_t)(n - i) * sizeof(retained[0]));
+      n++;
+    }
+    snprintf(retained[i], sizeof(retained[i]), "%s", de->d_name);
+  }
+  closedir(dir);
+}
+
+/**  @brief Move the export file aside under a time stamped name, delete the
+ * oldest rolled files beyond ARROWRETAIN and start a new file. A name already
+ * taken by a file rolled in the same second gets a sequence suffix that sorts
+ * after it.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether a new file was started.
+ */
+static int GhArrowRoll(void)
+{
+  char segname[2 * ARROWNAMESZ + 32], stamp[16];
+  time_t now = time(NULL);
+  struct tm tm;
+  int seq;
+
+  if (arrowfd != -1)
+  {
+    close(arrowfd);
+    arrowfd = -1;
+  }
+  localtime_r(&now, &tm);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+  snprintf(segname, sizeof(segname), "%s/%s%s.arrow", segdir, segprefix, stamp);
+  for (seq = 1; seq <= ARROWMAXSEQ && access(segname, F_OK) == 0; seq++)
+  {
+    snprintf(segname, sizeof(segname), "%s/%s%s_%02d.arrow", segdir, segprefix,
+             stamp, seq);
+  }
+  if (access(segname, F_OK) == 0)
+  {
+    // Every name of this second is taken, the file is left as it is
+    return 0;
+  }
+  rename(arrowname, segname);
+  GhArrowRetain();
+  return GhArrowStart();
+}
+
+/**  @brief Open an export file. A rolling export first moves a file left by
+ * an earlier run aside, a one off export replaces it.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname export file name.
+ *   @param rows rows per record batch, 0 holds rows back until set.
+ *   @param roll non zero to roll the file every ARROWROLLBATCHES batches.
+ *   @return 1 or 0 depending on whether the file is ready.
+ */
+int GhArrowOpen(const char *fname, int rows, int roll)
+{
+  char buf[ARROWNAMESZ];
+  struct stat st;
+  char *dot;
+
+  GhArrowClose();
+  snprintf(arrowname, sizeof(arrowname), "%s", fname);
+  snprintf(buf, sizeof(buf), "%s", fname);
+  snprintf(segdir, sizeof(segdir), "%s", dirname(buf));
+  snprintf(buf, sizeof(buf), "%s", fname);
+  snprintf(segprefix, sizeof(segprefix), "%s", basename(buf));
+  dot = strrchr(segprefix, '.');
+  if (dot != NULL)
+  {
+    *dot = '\0';
+  }
+  strncat(segprefix, "-", sizeof(segprefix) - strlen(segprefix) - 1);
+  arrowroll = roll;
+  GhArrowRows(rows);
+  if (roll && stat(fname, &st) == 0 && st.st_size > 0)
+  {
+    return GhArrowRoll();
+  }
+  return GhArrowStart();
+}
+
+/**  @brief Change the number of rows per record batch, writing the rows held
+ * back if the batch is already that long.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rows rows per record batch, 0 holds rows back until set again.
+ *   @return void
+ */
+void GhArrowRows(int rows)
+{
+  batchrows = rows < 0 ? 0 : rows > ARROWBATCHMAX ? ARROWBATCHMAX : rows;
+  if (nrows > 0 && (batchrows == 0 || nrows >= batchrows))
+  {
+    GhArrowFlush();
+  }
+}
+
+/**  @brief Store one value of the batch.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param c column number.
+ *   @param r row number.
+ *   @param present 0 to store a null.
+ *   @param v value of the column's width, an int for Bool columns.
+ *   @return void
+ */
+static void GhArrowSet(int c, int r, int present, const void *v)
+{
+  if (!present)
+  {
+    nulls[c]++;
+    return;
+  }
+  valid[c][r / 8] |= 1 << (r % 8);
+  if (columns[c].bits == 1)
+  {
+    data[c][r / 8] |= (*(const int *)v != 0) << (r % 8);
+  }
+  else
+  {
+    memcpy(data[c] + r * (columns[c].bits / 8), v, columns[c].bits / 8);
+  }
+}
+
+/**  @brief Add a row, writing a record batch once the batch is full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param row row to add.
+ *   @return 1 or 0 depending on whether the row was accepted.
+ */
+int GhArrowAppend(const arrowrow_s *row)
+{
+  int i;
+
+  if (arrowfd == -1 || nrows == ARROWBATCHMAX)
+  {
+    return 0;
+  }
+  GhArrowSet(0, nrows, 1, &row->ltime);
+  GhArrowSet(1, nrows, 1, &row->unit);
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    GhArrowSet(2 + i, nrows, row->value[i] == row->value[i], &row->value[i]);
+  }
+  GhArrowSet(5, nrows, row->actuators, &row->heater);
+  GhArrowSet(6, nrows, row->actuators, &row->humidifier);
+  GhArrowSet(7, nrows, row->actuators, &row->alarms);
+  nrows++;
+  if (batchrows > 0 && nrows >= batchrows)
+  {
+    return GhArrowFlush();
+  }
+  return 1;
+}
+
+/**  @brief Write the rows held back as a record batch. A rolling export
+ * rewrites the footer and rolls the file once it holds ARROWROLLBATCHES
+ * batches.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the batch was written.
+ */
+int GhArrowFlush(void)
+{
+  static const int rsize[3] = {8, 4, 4};
+  int64_t vlen[ARROWCOLUMNS], dlen[ARROWCOLUMNS], ent[2], length = nrows;
+  int64_t body = 0, off = 0;
+  size_t hpos, rpos[3], nodes, bufs, n;
+  arrowblock_s *p;
+  flatbuf_s fb;
+  int c, ok;
+
+  if (nrows == 0 || arrowfd == -1)
+  {
+    return arrowfd != -1;
+  }
+  for (c = 0; c < ARROWCOLUMNS; c++)
+  {
+    vlen[c] = columns[c].nullable && nulls[c] > 0 ? (nrows + 7) / 8 : 0;
+    dlen[c] = columns[c].bits == 1 ? (nrows + 7) / 8
+                                   : (int64_t)nrows * columns[c].bits / 8;
+    body += (vlen[c] + 7) / 8 * 8 + (dlen[c] + 7) / 8 * 8;
+  }
+
+  hpos = GhArrowMessageBegin(&fb, ARROWRECORDBATCH, body);
+  GhArrowLink(&fb, hpos, GhArrowTable(&fb, 3, rsize, rpos));
+  GhArrowPut(&fb, rpos[0], &length, sizeof(length));
+  nodes = GhArrowVector(&fb, ARROWCOLUMNS, 16, 8);
+  GhArrowLink(&fb, rpos[1], nodes);
+  bufs = GhArrowVector(&fb, 2 * ARROWCOLUMNS, 16, 8);
+  GhArrowLink(&fb, rpos[2], bufs);
+  for (c = 0; c < ARROWCOLUMNS; c++)
+  {
+    ent[0] = nrows;
+    ent[1] = columns[c].nullable ? nulls[c] : 0;
+    GhArrowPut(&fb, nodes + 4 + 16 * c, ent, sizeof(ent));
+    ent[0] = off;
+    ent[1] = vlen[c];
+    GhArrowPut(&fb, bufs + 4 + 32 * c, ent, sizeof(ent));
+    off += (vlen[c] + 7) / 8 * 8;
+    ent[0] = off;
+    ent[1] = dlen[c];
+    GhArrowPut(&fb, bufs + 20 + 32 * c, ent, sizeof(ent));
+    off += (dlen[c] + 7) / 8 * 8;
+  }
+  n = GhArrowMessageEnd(&fb);
+  if (n == 0)
+  {
+    return 0;
+  }
+
+  // Buffers follow the metadata, each padded to 8 bytes
+  memset(message + n, 0, body);
+  for (c = 0, off = n; c < ARROWCOLUMNS; c++)
+  {
+    memcpy(message + off, valid[c], vlen[c]);
+    off += (vlen[c] + 7) / 8 * 8;
+    memcpy(message + off, data[c], dlen[c]);
+    off += (dlen[c] + 7) / 8 * 8;
+  }
+  if (nblocks == blockcap)
+  {
+    p = GhArrowGrow(blocks, rollblocks, nblocks * sizeof(arrowblock_s),
+                    2 * (size_t)blockcap * sizeof(arrowblock_s));
+    if (p == NULL)
+    {
+      return 0;
+    }
+    blocks = p;
+    blockcap *= 2;
+  }
+  if (pwrite(arrowfd, message, n + body, dataend) != (ssize_t)(n + body))
+  {
+    perror("Error (call to 'pwrite')");
+    return 0;
+  }
+  blocks[nblocks].offset = dataend;
+  blocks[nblocks].metalength = n;
+  blocks[nblocks].pad = 0;
+  blocks[nblocks].bodylength = body;
+  nblocks++;
+  dataend += n + body;
+  ok = arrowroll ? GhArrowFooter() : 1;
+
+  nrows = 0;
+  memset(nulls, 0, sizeof(nulls));
+  memset(valid, 0, sizeof(valid));
+  memset(data, 0, sizeof(data));
+  if (arrowroll && nblocks >= ARROWROLLBATCHES)
+  {
+    ok = GhArrowRoll() && ok;
+  }
+  return ok;
+}
+
+/**  @brief Write the rows held back, the footer of a one off export, and
+ * close the export file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the file was completed.
+ */
+int GhArrowClose(void)
+{
+  int ok;
+
+  if (arrowfd == -1)
+  {
+    return 1;
+  }
+  ok = GhArrowFlush();
+  ok = (arrowroll || GhArrowFooter()) && ok;
+  ok = close(arrowfd) == 0 && ok;
+  arrowfd = -1;
+  return ok;
+}
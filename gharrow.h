@@ -0,0 +1,49 @@
+/**  @brief Apache Arrow IPC export constants, structures, function prototypes
+ *   @file gharrow.h
+ */
+#ifndef GHARROW_H
+#define GHARROW_H
+#include "ghlog.h"
+#include <stdint.h>
+#include <time.h>
+
+#define GHARROWFILE "ghreadings.arrow"
+#define ARROWROWS 30          // default rows per record batch, 0 disables
+#define ARROWBATCHMAX 512     // most rows a record batch can hold
+#define ARROWROLLBATCHES 1024 // batches in a file before it is rolled
+#define ARROWRETAIN 30        // rolled files kept, oldest are deleted first
+#define ARROWMAXSEQ 99        // files rolled within the same second
+#define ARROWCOLUMNS 8
+#define ARROWNAMESZ 256
+
+// One controller cycle. Times are local wall clock seconds like the data
+// log, bit n of alarms is set while alarm code n is active.
+typedef struct arrowrow
+{
+  int64_t ltime;
+  uint64_t unit;
+  double value[LOGFIELDS]; // NAN is exported as null
+  int actuators;           // set if heater, humidifier and alarms are known
+  int heater;
+  int humidifier;
+  uint32_t alarms;
+} arrowrow_s;
+
+// Where a message sits in the file, as listed in the footer
+typedef struct arrowblock
+{
+  int64_t offset;
+  int32_t metalength;
+  int32_t pad;
+  int64_t bodylength;
+} arrowblock_s;
+
+///@cond INTERNAL
+int GhArrowOpen(const char *fname, int rows, int roll);
+void GhArrowRows(int rows);
+int GhArrowAppend(const arrowrow_s *row);
+int GhArrowFlush(void);
+int GhArrowClose(void);
+///@endcond
+
+#endif
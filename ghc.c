@@ -2,42 +2,351 @@
  * ghcontrol.c and .h
  *   @file ghc.c
  */
+#include "gharrow.h"
+#include "ghconfig.h"
+#include "ghconsole.h"
 #include "ghcontrol.h"
+#include "ghhistory.h"
+#include "ghhttp.h"
+#include "ghjournal.h"
+#include "ghlog.h"
+#include "ghnotify.h"
+#include "ghpool.h"
+#include "ghring.h"
+#include "ghrotate.h"
+#include "ghsched.h"
+#include "ghsensors.h"
+#include "ghshm.h"
+#include "ghstate.h"
+#include "ghtrace.h"
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <time.h>
 
+static config_s config = {0};
+static setpoint_s sets = {0};
+static alarmlimit_s alimits = {0};
+static reading_s creadings = {0, NAN, NAN, NAN}; // Missing until sampled
+static reading_s lreadings = {0}; // Climate readings before the newest
+static control_s ctrl = {0};
+static alarm_s *arecord;
+static snapshot_s snap = {0};
+static int delay = GHUPDATE;      // Climate sampling period
+static int climatetask;
+static uint64_t readseq = 0;      // Bumped whenever creadings changes
+static uint64_t logged = 0;       // History samples already in the data log
+
+/**  @brief Task applying configuration file changes.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcConfig(void *arg)
+{
+  int reloaded = GhConfigPoll(&config);
+
+  if (reloaded == 1)
+  {
+    sets = config.spts;
+    alimits = config.alimits;
+    GhConsoleInit(config.console);
+    GhRotatePolicy(config.rotate);
+    GhFilterSetup(config.filter);
+    GhArrowRows(config.arrowrows);
+    GhHistorySetup(config.historysamples);
+    GhNotifyGap(config.notifygap);
+  }
+  else if (reloaded == -1)
+  {
+    snap.configerrors++;
+  }
+}
+
+/**  @brief Note new readings, add them to the history with the actuator
+ * states they were taken under and append their raw counts when enabled.
+ * Every reading reaches the history and the log, however fast it is sampled.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+static void GhcAcquired(void)
+{
+  readseq++;
+  GhHistoryAdd(creadings, ctrl);
+  if (config.rawlog != RAWLOGOFF &&
+      !GhSensorsLogRaw(GHRAWFILE, GhGetSerial(), creadings.rtime))
+  {
+    snap.logerrors++;
+  }
+}
+
+/**  @brief Task sampling temperature and humidity. Its period follows the
+ * adaptive sampling delay.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcClimate(void *arg)
+{
+  lreadings = creadings;
+  creadings = GhUpdateReadings(creadings, (1 << TEMPERATURE) | (1 << HUMIDITY));
+  GhcAcquired();
+  delay = GhSampleDelay(creadings, lreadings, alimits, delay, config.samplemin,
+                        config.samplemax);
+  GhSchedPeriod(climatetask, delay);
+}
+
+/**  @brief Task sampling pressure, which changes slowly. The value rides
+ * along with the next climate sample rather than making a reading of its
+ * own, so it never repeats the last temperature and humidity as new.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcPressure(void *arg)
+{
+  creadings.pressure = GhUpdateReadings(creadings, 1 << PRESSURE).pressure;
+}
+
+/**  @brief Task setting the heater and humidifier from new readings.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcControl(void *arg)
+{
+  static uint64_t seen = 0;
+
+  if (seen == readseq)
+  {
+    return;
+  }
+  seen = readseq;
+  ctrl = GhSetControls(sets, creadings);
+}
+
+/**  @brief Task evaluating alarms on new readings and saving state.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcAlarms(void *arg)
+{
+  static uint64_t seen = 0;
+
+  if (seen == readseq)
+  {
+    return;
+  }
+  seen = readseq;
+  arecord = GhSetAlarms(arecord, alimits, creadings);
+  GhStateSave(creadings, arecord);
+}
+
+/**  @brief Task publishing a snapshot of new readings to shared memory, the
+ * Arrow export and the console.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcPublish(void *arg)
+{
+  static uint64_t seen = 0;
+  arrowrow_s row;
+
+  if (seen == readseq)
+  {
+    return;
+  }
+  seen = readseq;
+  GhSnapshotFill(&snap, creadings, sets, ctrl, arecord);
+  snap.samplems = delay;
+  GhShmPublish(&snap);
+  row = GhSnapshotRow(&snap);
+  if (config.arrowrows > 0 && !GhArrowAppend(&row))
+  {
+    snap.logerrors++;
+  }
+  GhConsoleRender(&snap);
+}
+
+/**  @brief Write readings to the circular log if one is configured,
+ * otherwise append them to the text log in one write.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rdata readings in time order.
+ *   @param n number of readings, at most LOGBATCH.
+ *   @return number of readings that could not be written.
+ */
+static int GhcLogReadings(const reading_s *rdata, int n)
+{
+  double value[LOGFIELDS];
+  int failed = 0, i;
+
+  if (config.ringrecords == 0)
+  {
+    GhRotateCheck(GHDATAFILE, rdata[0].rtime);
+    return GhLogBatch(GHDATAFILE, rdata, n) ? 0 : n;
+  }
+  if (!GhRingOpen(GHRINGFILE, config.ringrecords, GhGetSerial()))
+  {
+    return n;
+  }
+  for (i = 0; i < n; i++)
+  {
+    value[LOGTEMP] = rdata[i].temperature;
+    value[LOGHUMID] = rdata[i].humidity;
+    value[LOGPRESS] = rdata[i].pressure;
+    failed += !GhRingAppend(rdata[i].rtime, value);
+  }
+  return failed;
+}
+
+/**  @brief Task writing the readings added to the history since its last
+ * run to the data log in batches of up to LOGBATCH. The history counts what
+ * it has been given, so a clock step neither repeats nor skips a reading;
+ * any that left the history unread count as log errors.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcLog(void *arg)
+{
+  static reading_s batch[LOGBATCH];
+  const histsample_s *part[2];
+  int n[2], i, j, missed, count = 0;
+
+  GhHistorySince(&logged, part, n, &missed);
+  if (config.rawlog == RAWLOGONLY)
+  {
+    return;
+  }
+  snap.logerrors += missed;
+  for (j = 0; j < 2; j++)
+  {
+    for (i = 0; i < n[j]; i++)
+    {
+      batch[count++] = part[j][i].reading;
+      if (count == LOGBATCH)
+      {
+        snap.logerrors += GhcLogReadings(batch, count);
+        count = 0;
+      }
+    }
+  }
+  if (count > 0)
+  {
+    snap.logerrors += GhcLogReadings(batch, count);
+  }
+  if (config.ringrecords == 0)
+  {
+    GhRingClose();
+  }
+}
+
+/**  @brief Task drawing the readings on the LED matrix.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcDisplay(void *arg)
+{
+  GhDisplayAll(creadings, sets);
+}
+
+/**  @brief Task rotating the text log on schedule while no batch is due. The
+ * circular log never needs rotating.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return void
+ */
+static void GhcHousekeeping(void *arg)
+{
+  if (config.rawlog != RAWLOGONLY && config.ringrecords == 0)
+  {
+    GhRotateCheck(GHDATAFILE, time(NULL));
+  }
+}
+
 int main()
 {
-  control_s ctrl = {0};
-  setpoint_s sets = {0};
-  reading_s creadings = {0};
-  alarmlimit_s alimits = {0};
-  alarm_s *arecord;
-  arecord = (alarm_s *)calloc(1, sizeof(alarm_s));
+  uint64_t cstart;
+  time_t lastdump = 0;
+  int wait;
+
+  arecord = GhAlarmNew();
   if (arecord == NULL)
   {
     puts("Cannot allocate memory");
   }
 
-  sets = GhSetTargets();
-  alimits = GhSetAlarmLimits();
+  GhConfigLoad(GHCONFIGFILE, &config);
+  GhConfigWatch(GHCONFIGFILE);
+  sets = config.spts;
+  alimits = config.alimits;
+  GhFilterSetup(config.filter);
+  if (GhStateOpen(GHSTATEFILE) == 1 && GhStateRestore(&creadings, arecord))
+  {
+    puts("Resuming from saved controller state");
+  }
+  GhJournalOpen(GHJOURNALFILE);
+  GhNotifyStart(config.notifygap);
+  GhShmCreate(GHSHMNAME);
+  GhHttpOpen(GHHTTPPORT);
+  GhRotateInit(GHDATAFILE, config.rotate);
+  GhArrowOpen(GHARROWFILE, config.arrowrows, 1);
+  GhHistorySetup(config.historysamples);
   GhControllerInit();
-  int logged;
+  GhConsoleInit(config.console);
+  GhPoolSeal();
+  GhTraceInit();
+
+  // Producers first, so a reading is used in the tick it is taken
+  GhSchedAdd("config", SCHEDCONFIGMS, 0, GhcConfig, NULL);
+  GhSchedAdd("pressure", SCHEDPRESSUREMS, 0, GhcPressure, NULL);
+  climatetask = GhSchedAdd("climate", delay, 0, GhcClimate, NULL);
+  GhSchedAdd("control", SCHEDCONTROLMS, 0, GhcControl, NULL);
+  GhSchedAdd("alarms", SCHEDALARMMS, 0, GhcAlarms, NULL);
+  GhSchedAdd("publish", SCHEDPUBLISHMS, 0, GhcPublish, NULL);
+  GhSchedAdd("log", SCHEDLOGMS, SCHEDLOGMS, GhcLog, NULL);
+  GhSchedAdd("display", SCHEDDISPLAYMS, SCHEDTICKMS, GhcDisplay, NULL);
+  GhSchedAdd("housekeeping", SCHEDHOUSEMS, SCHEDHOUSEMS / 2, GhcHousekeeping,
+             NULL);
 
   while (1)
   {
-    creadings = GhGetReadings();
-    logged = GhLogData("ghdata.txt", creadings);
-    GhDisplayAll(creadings, sets);
-    GhDisplayReadings(creadings);
-    GhDisplayTargets(sets);
-    ctrl = GhSetControls(sets, creadings);
-    arecord = GhSetAlarms(arecord, alimits, creadings);
-    GhDisplayControls(ctrl);
-    GhDisplayAlarms(arecord);
-    GhDelay(GHUPDATE);
+    cstart = GhClockMicros();
+    GhTraceBegin("cycle", (int32_t)snap.cycles);
+    GhSchedRun();
+    GhTraceEnd("cycle");
+    snap.cycleus = GhClockMicros() - cstart;
+    if (snap.cycleus > snap.maxcycleus)
+    {
+      snap.maxcycleus = snap.cycleus;
+    }
+    // Dump on SIGUSR1, or after an overrun at most once per TRACEDUMPGAP
+    if (GhTraceRequested() || (snap.cycleus > TRACEDEADLINEUS &&
+                               time(NULL) - lastdump >= TRACEDUMPGAP))
+    {
+      GhTraceDump(GHTRACEFILE);
+      lastdump = time(NULL);
+    }
+    // The only sleep, HTTP clients are served until the next task is due
+    wait = GhSchedWait();
+    GhTraceBegin("wait", wait);
+    GhHttpServe(&snap, wait);
+    GhTraceEnd("wait");
   }
 
   return EXIT_FAILURE;
-}
\ No newline at end of file
+}
@@ -0,0 +1,401 @@
+/**  @brief Code for loading, saving and watching the runtime configuration
+ *   @file ghconfig.c
+ */
+#include "ghconfig.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+typedef struct configkey
+{
+  const char *name;
+  size_t offset;
+  configtype_e type;
+} configkey_s;
+
+static const configkey_s configkeys[] = {
+    {"settemp", offsetof(config_s, spts.temperature), CONFIGDOUBLE},
+    {"sethumid", offsetof(config_s, spts.humidity), CONFIGDOUBLE},
+    {"hightemp", offsetof(config_s, alimits.hight), CONFIGDOUBLE},
+    {"lowtemp", offsetof(config_s, alimits.lowt), CONFIGDOUBLE},
+    {"highhumid", offsetof(config_s, alimits.highh), CONFIGDOUBLE},
+    {"lowhumid", offsetof(config_s, alimits.lowh), CONFIGDOUBLE},
+    {"highpress", offsetof(config_s, alimits.highp), CONFIGDOUBLE},
+    {"lowpress", offsetof(config_s, alimits.lowp), CONFIGDOUBLE},
+    {"hysttemp", offsetof(config_s, alimits.hystt), CONFIGDOUBLE},
+    {"hysthumid", offsetof(config_s, alimits.hysth), CONFIGDOUBLE},
+    {"hystpress", offsetof(config_s, alimits.hystp), CONFIGDOUBLE},
+    {"ratetemp", offsetof(config_s, alimits.ratet), CONFIGDOUBLE},
+    {"ratehumid", offsetof(config_s, alimits.rateh), CONFIGDOUBLE},
+    {"ratepress", offsetof(config_s, alimits.ratep), CONFIGDOUBLE},
+    {"alarmdebounce", offsetof(config_s, alimits.debounce), CONFIGINT},
+    {"console", offsetof(config_s, console), CONFIGINT},
+    {"samplemin", offsetof(config_s, samplemin), CONFIGINT},
+    {"samplemax", offsetof(config_s, samplemax), CONFIGINT},
+    {"rotatesizekb", offsetof(config_s, rotate.sizekb), CONFIGINT},
+    {"rotateperiod", offsetof(config_s, rotate.period), CONFIGINT},
+    {"rotateretain", offsetof(config_s, rotate.retain), CONFIGINT},
+    {"filteralpha", offsetof(config_s, filter.alpha), CONFIGDOUBLE},
+    {"filtermedian", offsetof(config_s, filter.median), CONFIGINT},
+    {"filtersigma", offsetof(config_s, filter.sigma), CONFIGDOUBLE},
+    {"arrowrows", offsetof(config_s, arrowrows), CONFIGINT},
+    {"historysamples", offsetof(config_s, historysamples), CONFIGINT},
+    {"rawlog", offsetof(config_s, rawlog), CONFIGINT},
+    {"notifygap", offsetof(config_s, notifygap), CONFIGINT},
+    {"ringrecords", offsetof(config_s, ringrecords), CONFIGINT},
+};
+#define NCONFIGKEYS (sizeof(configkeys) / sizeof(configkeys[0]))
+
+static int inotifyfd = -1;           // inotify handle for the config directory
+static char watchname[CONFIGLINESZ]; // config file name inside that directory
+static char watchpath[CONFIGLINESZ]; // full path of the watched config file
+
+/**  @brief Store a parsed value into the configuration field for a key.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cfg configuration to update.
+ *   @param key key describing the field.
+ *   @param value parsed value.
+ *   @return void
+ */
+static void GhConfigSet(config_s *cfg, const configkey_s *key, double value)
+{
+  if (key->type == CONFIGINT)
+  {
+    *(int *)((char *)cfg + key->offset) = (int)value;
+  }
+  else
+  {
+    *(double *)((char *)cfg + key->offset) = value;
+  }
+}
+
+/**  @brief Build a configuration from the compiled in defaults.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return configuration holding default setpoints and alarm limits.
+ */
+config_s GhConfigDefaults(void)
+{
+  config_s cfg = {0};
+  cfg.spts.temperature = STEMP;
+  cfg.spts.humidity = SHUMID;
+  cfg.alimits = GhSetAlarmLimits();
+  cfg.console = CONSOLEAUTO;
+  cfg.samplemin = GHUPDATEMIN;
+  cfg.samplemax = GHUPDATEMAX;
+  cfg.rotate.sizekb = ROTATESIZEKB;
+  cfg.rotate.period = ROTATENONE;
+  cfg.rotate.retain = ROTATERETAIN;
+  cfg.filter.alpha = FILTERALPHA;
+  cfg.filter.median = FILTERMEDIAN;
+  cfg.filter.sigma = FILTERSIGMA;
+  cfg.arrowrows = ARROWROWS;
+  cfg.historysamples = HISTSAMPLES;
+  cfg.rawlog = RAWLOG;
+  cfg.notifygap = NOTIFYGAP;
+  cfg.ringrecords = RINGRECORDS;
+  return cfg;
+}
+
+/**  @brief Parse a key = value text file into a configuration.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to the configuration file name.
+ *   @param cfg configuration updated with every key found in the file.
+ *   @return 1 on success, 0 if the file cannot be opened or is malformed.
+ */
+int GhConfigParse(const char *fname, config_s *cfg)
+{
+  FILE *fp;
+  char buf[CONFIGLINESZ];
+  char key[CONFIGKEYSZ];
+  double value;
+  int i, lineno = 0;
+
+  fp = fopen(fname, "r");
+  if (fp == NULL)
+  {
+    return 0;
+  }
+  while (fgets(buf, sizeof(buf), fp) != NULL)
+  {
+    lineno++;
+    char *p = buf + strspn(buf, " \t");
+    if (*p == '#' || *p == '\n' || *p == '\0')
+    {
+      continue;
+    }
+    if (sscanf(p, "%31[^ \t=] = %lf", key, &value) != 2)
+    {
+      fprintf(stderr, "%s:%d: malformed line\n", fname, lineno);
+      fclose(fp);
+      return 0;
+    }
+    for (i = 0; i < NCONFIGKEYS; i++)
+    {
+      if (strcmp(key, configkeys[i].name) == 0)
+      {
+        GhConfigSet(cfg, &configkeys[i], value);
+        break;
+      }
+    }
+    if (i == NCONFIGKEYS)
+    {
+      fprintf(stderr, "%s:%d: unknown key '%s'\n", fname, lineno, key);
+    }
+  }
+  fclose(fp);
+  return 1;
+}
+
+/**  @brief Check that a configuration is usable by the controller.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cfg configuration to check.
+ *   @return 1 if every setpoint is in range and every limit pair is ordered.
+ */
+int GhConfigValidate(config_s cfg)
+{
+  if (cfg.spts.temperature < LSTEMP || cfg.spts.temperature > USTEMP ||
+      cfg.spts.humidity < LSHUMID || cfg.spts.humidity > USHUMID)
+  {
+    return 0;
+  }
+  if (cfg.alimits.lowt >= cfg.alimits.hight ||
+      cfg.alimits.lowh >= cfg.alimits.highh ||
+      cfg.alimits.lowp >= cfg.alimits.highp)
+  {
+    return 0;
+  }
+  if (cfg.alimits.hystt < 0 || cfg.alimits.hysth < 0 ||
+      cfg.alimits.hystp < 0 || cfg.alimits.ratet < 0 ||
+      cfg.alimits.rateh < 0 || cfg.alimits.ratep < 0 ||
+      cfg.alimits.debounce < 0)
+  {
+    return 0;
+  }
+  if (cfg.console < CONSOLEAUTO || cfg.console > CONSOLEQUIET)
+  {
+    return 0;
+  }
+  if (cfg.samplemin < 1 || cfg.samplemax < cfg.samplemin)
+  {
+    return 0;
+  }
+  if (cfg.rotate.sizekb < 0 || cfg.rotate.period < ROTATENONE ||
+      cfg.rotate.period > ROTATEMONTHLY || cfg.rotate.retain < 1 ||
+      cfg.rotate.retain > ROTATEMAXSEGS)
+  {
+    return 0;
+  }
+  if (cfg.filter.alpha <= 0 || cfg.filter.alpha > 1 || cfg.filter.median < 1 ||
+      cfg.filter.median > FILTERWINDOW || cfg.filter.median % 2 == 0 ||
+      cfg.filter.sigma < 0)
+  {
+    return 0;
+  }
+  if (cfg.arrowrows < 0 || cfg.arrowrows > ARROWBATCHMAX)
+  {
+    return 0;
+  }
+  if (cfg.historysamples < 1 || cfg.historysamples > HISTSAMPLESMAX)
+  {
+    return 0;
+  }
+  // Every reading taken between two log batches must still be in the history
+  if (cfg.historysamples <
+      SCHEDLOGMS / cfg.samplemin + SCHEDLOGMS / SCHEDPRESSUREMS + 1)
+  {
+    return 0;
+  }
+  if (cfg.rawlog < RAWLOGOFF || cfg.rawlog > RAWLOGONLY)
+  {
+    return 0;
+  }
+  if (cfg.notifygap < 0 || cfg.notifygap > NOTIFYGAPMAX)
+  {
+    return 0;
+  }
+  if (cfg.ringrecords < 0 || cfg.ringrecords > RINGRECORDSMAX)
+  {
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Write a configuration to a temporary file and rename it over fname.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to the configuration file name.
+ *   @param cfg configuration to write.
+ *   @return 1 or 0 depending on whether the file was replaced.
+ */
+int GhConfigSave(const char *fname, config_s cfg)
+{
+  FILE *fp;
+  char tmpname[CONFIGLINESZ];
+  int i;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", fname);
+  fp = fopen(tmpname, "w");
+  if (fp == NULL)
+  {
+    return 0;
+  }
+  fprintf(fp, "# Greenhouse controller configuration\n");
+  for (i = 0; i < NCONFIGKEYS; i++)
+  {
+    if (configkeys[i].type == CONFIGINT)
+    {
+      fprintf(fp, "%s = %d\n", configkeys[i].name,
+              *(int *)((char *)&cfg + configkeys[i].offset));
+    }
+    else
+    {
+      // Enough digits that every value typed into the file reads back as is
+      fprintf(fp, "%s = %.15g\n", configkeys[i].name,
+              *(double *)((char *)&cfg + configkeys[i].offset));
+    }
+  }
+  if (fflush(fp) != 0 || fsync(fileno(fp)) != 0)
+  {
+    fclose(fp);
+    unlink(tmpname);
+    return 0;
+  }
+  fclose(fp);
+  if (rename(tmpname, fname) != 0)
+  {
+    unlink(tmpname);
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Load the configuration, creating the file from the current setpoints
+ * and default limits if it does not exist yet.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to the configuration file name.
+ *   @param cfg receives the loaded configuration.
+ *   @return 1 if cfg was loaded from or saved to fname, 0 if defaults are used.
+ */
+int GhConfigLoad(const char *fname, config_s *cfg)
+{
+  config_s ncfg = GhConfigDefaults();
+
+  if (access(fname, F_OK) != 0)
+  {
+    ncfg.spts = GhSetTargets();
+    *cfg = ncfg;
+    return GhConfigSave(fname, ncfg);
+  }
+  if (!GhConfigParse(fname, &ncfg) || !GhConfigValidate(ncfg))
+  {
+    fprintf(stderr, "%s: invalid configuration, using defaults\n", fname);
+    *cfg = GhConfigDefaults();
+    return 0;
+  }
+  *cfg = ncfg;
+  return 1;
+}
+
+/**  @brief Start watching the configuration file for changes.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to the configuration file name.
+ *   @return inotify file descriptor or -1 on failure.
+ */
+int GhConfigWatch(const char *fname)
+{
+  char dir[CONFIGLINESZ], base[CONFIGLINESZ];
+
+  GhConfigClose();
+  snprintf(dir, sizeof(dir), "%s", fname);
+  snprintf(base, sizeof(base), "%s", fname);
+  snprintf(watchname, sizeof(watchname), "%s", basename(base));
+  snprintf(watchpath, sizeof(watchpath), "%s", fname);
+
+  inotifyfd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotifyfd == -1)
+  {
+    perror("Error (call to 'inotify_init1')");
+    return -1;
+  }
+  // Watch the directory, editors and GhConfigSave replace the file by rename
+  if (inotify_add_watch(inotifyfd, dirname(dir),
+                        IN_CLOSE_WRITE | IN_MOVED_TO) == -1)
+  {
+    perror("Error (call to 'inotify_add_watch')");
+    GhConfigClose();
+    return -1;
+  }
+  return inotifyfd;
+}
+
+/**  @brief Reload the configuration if the watched file has changed.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cfg configuration replaced as a whole when a valid file is read.
+ *   @return 1 if cfg was replaced, 0 if unchanged, -1 if the new file was
+ * rejected.
+ */
+int GhConfigPoll(config_s *cfg)
+{
+  char buf[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  const struct inotify_event *ev;
+  ssize_t len;
+  char *p;
+  int changed = 0;
+  config_s ncfg;
+
+  if (inotifyfd == -1)
+  {
+    return 0;
+  }
+  while ((len = read(inotifyfd, buf, sizeof(buf))) > 0)
+  {
+    for (p = buf; p < buf + len; p += sizeof(*ev) + ev->len)
+    {
+      ev = (const struct inotify_event *)p;
+      if (ev->len > 0 && strcmp(ev->name, watchname) == 0)
+      {
+        changed = 1;
+      }
+    }
+  }
+  if (!changed)
+  {
+    return 0;
+  }
+
+  ncfg = GhConfigDefaults();
+  if (!GhConfigParse(watchpath, &ncfg) || !GhConfigValidate(ncfg))
+  {
+    fprintf(stderr, "%s: invalid configuration, keeping current\n", watchpath);
+    return -1;
+  }
+  *cfg = ncfg;
+  return 1;
+}
+
+/**  @brief Stop watching the configuration file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhConfigClose(void)
+{
+  if (inotifyfd != -1)
+  {
+    close(inotifyfd);
+    inotifyfd = -1;
+  }
+}
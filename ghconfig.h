@@ -0,0 +1,54 @@
+/**  @brief Runtime configuration constants, structures, function prototypes
+ *   @file ghconfig.h
+ */
+#ifndef GHCONFIG_H
+#define GHCONFIG_H
+#include "gharrow.h"
+#include "ghconsole.h"
+#include "ghcontrol.h"
+#include "ghfilter.h"
+#include "ghhistory.h"
+#include "ghnotify.h"
+#include "ghraw.h"
+#include "ghring.h"
+#include "ghsched.h"
+#include "ghrotate.h"
+
+#define GHCONFIGFILE "ghconfig.txt"
+#define CONFIGLINESZ 128
+#define CONFIGKEYSZ 32
+
+typedef enum
+{
+  CONFIGDOUBLE,
+  CONFIGINT
+} configtype_e;
+
+typedef struct config
+{
+  setpoint_s spts;
+  alarmlimit_s alimits;
+  int console;
+  int samplemin;
+  int samplemax;
+  rotatepolicy_s rotate;
+  filterconfig_s filter;
+  int arrowrows;
+  int historysamples;
+  int rawlog;
+  int notifygap;
+  int ringrecords;
+} config_s;
+
+///@cond INTERNAL
+config_s GhConfigDefaults(void);
+int GhConfigParse(const char *fname, config_s *cfg);
+int GhConfigValidate(config_s cfg);
+int GhConfigSave(const char *fname, config_s cfg);
+int GhConfigLoad(const char *fname, config_s *cfg);
+int GhConfigWatch(const char *fname);
+int GhConfigPoll(config_s *cfg);
+void GhConfigClose(void);
+///@endcond
+
+#endif
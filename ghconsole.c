@@ -0,0 +1,144 @@
+/**  @brief Code for the single write, in place console status screen
+ *   @file ghconsole.c
+ */
+#include "ghconsole.h"
+#include "ghlog.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static consolemode_e cmode = CONSOLEAUTO; // Resolved output mode
+static consoleframe_s frames[2];          // Current and previously shown frame
+static int shown = -1;                    // Index of the frame on screen
+static char out[CONSOLEOUTSZ];            // Bytes sent in a single write
+static logstamp_s rstamp;                 // Stamp cache for the reading time
+static logstamp_s astamp[NALARMS];        // Stamp cache for each alarm line
+
+/**  @brief Select how the status screen is written.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param mode CONSOLEAUTO picks ANSI for terminals and plain text otherwise.
+ *   @return void
+ */
+void GhConsoleInit(consolemode_e mode)
+{
+  if (mode == CONSOLEAUTO)
+  {
+    mode = isatty(STDOUT_FILENO) ? CONSOLEANSI : CONSOLEPLAIN;
+  }
+  if (mode != cmode)
+  {
+    // Force a full redraw after a mode change
+    shown = -1;
+  }
+  cmode = mode;
+}
+
+/**  @brief Format the status screen for a snapshot into a frame.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param frame frame receiving the lines.
+ *   @return void
+ */
+static void GhConsoleFormat(const snapshot_s *snap, consoleframe_s *frame)
+{
+  uint32_t i;
+  int n = 0;
+
+  snprintf(frame->line[n++], CONSOLELINESZ, "Unit:%llx %s Cycle %llu",
+           (unsigned long long)snap->serial,
+           GhLogStamp(&rstamp, snap->reading.rtime),
+           (unsigned long long)snap->cycles);
+  snprintf(frame->line[n++], CONSOLELINESZ,
+           "Readings\tT: %5.1lfC\tH: %5.1lf%%\tP: %6.1lfmb",
+           snap->reading.temperature, snap->reading.humidity,
+           snap->reading.pressure);
+  snprintf(frame->line[n++], CONSOLELINESZ,
+           "Targets\t\tT: %5.1lfC\tH: %5.1lf%%", snap->spts.temperature,
+           snap->spts.humidity);
+  snprintf(frame->line[n++], CONSOLELINESZ,
+           "Controls\tHeater: %i\tHumidifier: %i", snap->ctrl.heater,
+           snap->ctrl.humidifier);
+  frame->line[n++][0] = '\0';
+  snprintf(frame->line[n++], CONSOLELINESZ, "Alarms");
+  for (i = 0; i < snap->nalarms && n < CONSOLELINES; i++)
+  {
+    snprintf(frame->line[n++], CONSOLELINESZ, "%s %s",
+             alarmnames[snap->alarms[i].code],
+             GhLogStamp(&astamp[i], (time_t)snap->alarms[i].atime));
+  }
+  frame->nlines = n;
+}
+
+/**  @brief Draw the status screen. In ANSI mode only lines that changed since
+ * the last frame are rewritten in place. All output goes out in one write.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @return void
+ */
+void GhConsoleRender(const snapshot_s *snap)
+{
+  consoleframe_s *cur, *prev;
+  size_t len = 0;
+  int i, n, next;
+
+  if (cmode == CONSOLEAUTO)
+  {
+    GhConsoleInit(CONSOLEAUTO);
+  }
+  if (cmode == CONSOLEQUIET)
+  {
+    return;
+  }
+  next = shown == 0 ? 1 : 0;
+  cur = &frames[next];
+  prev = shown == -1 ? NULL : &frames[shown];
+  GhConsoleFormat(snap, cur);
+
+  if (cmode == CONSOLEPLAIN)
+  {
+    for (i = 0; i < cur->nlines; i++)
+    {
+      n = snprintf(out + len, sizeof(out) - len, "%s\n", cur->line[i]);
+      len += n;
+    }
+    len += snprintf(out + len, sizeof(out) - len, "\n");
+  }
+  else
+  {
+    if (prev == NULL)
+    {
+      len += snprintf(out + len, sizeof(out) - len, "\x1b[H\x1b[2J");
+    }
+    for (i = 0; i < cur->nlines; i++)
+    {
+      if (prev != NULL && i < prev->nlines &&
+          strcmp(cur->line[i], prev->line[i]) == 0)
+      {
+        continue;
+      }
+      len += snprintf(out + len, sizeof(out) - len, "\x1b[%d;1H%s\x1b[K", i + 1,
+                      cur->line[i]);
+    }
+    if (prev != NULL)
+    {
+      // Blank lines left over from a longer previous frame
+      for (i = cur->nlines; i < prev->nlines; i++)
+      {
+        len += snprintf(out + len, sizeof(out) - len, "\x1b[%d;1H\x1b[K",
+                        i + 1);
+      }
+    }
+    len += snprintf(out + len, sizeof(out) - len, "\x1b[%d;1H",
+                    cur->nlines + 1);
+  }
+  shown = next;
+  if (len > 0)
+  {
+    fflush(stdout);
+    write(STDOUT_FILENO, out, len);
+  }
+}
@@ -0,0 +1,31 @@
+/**  @brief Console status renderer constants, structures, function prototypes
+ *   @file ghconsole.h
+ */
+#ifndef GHCONSOLE_H
+#define GHCONSOLE_H
+#include "ghcontrol.h"
+
+#define CONSOLELINES (8 + NALARMS)
+#define CONSOLELINESZ 96
+#define CONSOLEOUTSZ (CONSOLELINES * (CONSOLELINESZ + 16) + 16)
+
+typedef enum
+{
+  CONSOLEAUTO,
+  CONSOLEANSI,
+  CONSOLEPLAIN,
+  CONSOLEQUIET
+} consolemode_e;
+
+typedef struct consoleframe
+{
+  int nlines;
+  char line[CONSOLELINES][CONSOLELINESZ];
+} consoleframe_s;
+
+///@cond INTERNAL
+void GhConsoleInit(consolemode_e mode);
+void GhConsoleRender(const snapshot_s *snap);
+///@endcond
+
+#endif
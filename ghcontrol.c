@@ -2,40 +2,81 @@
  *   @file ghcontrol.c
  */
 #include "ghcontrol.h"
+#include "ghfilter.h"
+#include "ghindex.h"
+#include "ghjournal.h"
+#include "ghlog.h"
+#include "ghnotify.h"
+#include "ghpool.h"
+#include "ghsensors.h"
 #include "pisensehat.h"
+#include <fcntl.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
+#include <sys/stat.h>
 #include <time.h>
-const char alarmnames[NALARMS][ALARMNMSZ] = {
-    "No Alarms", "High Temperature", "Low Temperature", "High Humidity",
-    "Low Humidity", "High Pressure", "Low Pressure"};
+#include <unistd.h>
 
-/**  @brief Delay program for a specific amount of time.
- *   @version 9APR2021
+typedef struct alarmtrack
+{
+  time_t since; // when the pending raise or clear was first seen, 0 if none
+} alarmtrack_s;
+typedef struct ratetrack
+{
+  time_t rtime; // time of the reading the current window starts at
+  double value; // reading the current window starts at
+  double rate;  // smoothed change per minute
+} ratetrack_s;
+
+static alarmtrack_s atrack[NALARMS]; // Debounce state of each alarm
+static ratetrack_s rtrack[SENSORS];  // Rate of change state of each sensor
+static time_t sampled[SENSORS];      // Time each sensor was last sampled
+#if !(SIMTEMPERATURE && SIMHUMIDITY && SIMPRESSURE)
+static double sensed[SENSORS]; // Latest combined reading of the registry
+#endif
+#if GHSTATIC
+static pool_s *alarmpool;            // Alarm nodes, one per alarm code
+#endif
+
+/**  @brief Delay program for a specific amount of time, sleeping rather than
+ * spinning so the processor is idle while the controller waits.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @param milliseconds Holds a value of time in milliseconds.
  *   @return void
  */
 void GhDelay(int milliseconds)
 {
-  long wait;
-  clock_t now, start;
+  struct timespec wait;
 
-  wait = milliseconds * (CLOCKS_PER_SEC / 1000);
-  start = clock();
-  now = start;
-  while ((now - start) < wait)
+  wait.tv_sec = milliseconds / 1000;
+  wait.tv_nsec = (milliseconds % 1000) * 1000000L;
+  while (nanosleep(&wait, &wait) == -1)
   {
-    now = clock();
+    // Interrupted by a signal, sleep for the time that remains
   }
 }
 
+/**  @brief Read the monotonic clock.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return time in microseconds since an arbitrary fixed point.
+ */
+uint64_t GhClockMicros(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
 /**  @brief Get serial number of host computer.
  *   @version 9APR2021
  *   @author Caio Cotts
- *   @return Serial number as a long unsigned integer.
+ *   @return Serial number as a long unsigned integer, probed on the first call
+ * only.
  */
 uint64_t GhGetSerial(void)
 {
@@ -44,6 +85,12 @@ uint64_t GhGetSerial(void)
   FILE *fp;
   char buf[SYSINFOBUFSZ];
   char searchstring[] = SEARCHSTR;
+  static int probed = 0;
+  if (probed)
+  {
+    return serial;
+  }
+  probed = 1;
   fp = fopen("/proc/cpuinfo", "r");
   if (fp != NULL)
   {
@@ -103,8 +150,12 @@ void GhControllerInit(void)
   srand((unsigned)time(NULL));
   GhDisplayHeader("Caio Cotts");
 #if SENSEHAT
+  // Returns at once, devices are probed in the background
   ShInit();
 #endif
+#if !(SIMTEMPERATURE && SIMHUMIDITY && SIMPRESSURE)
+  GhSensorsInit(GHSENSORFILE);
+#endif
 }
 
 /**  @brief Display current time and sensor readings.
@@ -115,10 +166,11 @@ void GhControllerInit(void)
  */
 void GhDisplayReadings(reading_s rdata)
 {
+  static logstamp_s stamp;
   fprintf(stdout,
-          "\nUnit:%Lx %s Readings\tT: %5.1lfC\tH: %5.1lf%%\tP: %6.1lfmb\n ",
-          GhGetSerial(), ctime(&rdata.rtime), rdata.temperature, rdata.humidity,
-          rdata.pressure);
+          "\nUnit:%Lx %s\n Readings\tT: %5.1lfC\tH: %5.1lf%%\tP: %6.1lfmb\n ",
+          GhGetSerial(), GhLogStamp(&stamp, rdata.rtime), rdata.temperature,
+          rdata.humidity, rdata.pressure);
 }
 
 /**  @brief Get current humidity measurements.
@@ -131,9 +183,7 @@ double GhGetHumidity(void)
 #if SIMHUMIDITY
   return GhGetRandom(USHUMID - LSHUMID) + LSHUMID;
 #else
-  ht221sData_s ch = {0};
-  ch = ShGetHT221SData();
-  return ch.humidity;
+  return sensed[HUMIDITY];
 #endif
 }
 
@@ -147,9 +197,7 @@ double GhGetPressure(void)
 #if SIMPRESSURE
   return GhGetRandom(USPRESS - LSPRESS) + LSPRESS;
 #else
-  lps25hData_s cp = {0};
-  cp = ShGetLPS25HData();
-  return cp.pressure;
+  return sensed[PRESSURE];
 #endif
 }
 
@@ -164,30 +212,67 @@ double GhGetTemperature(void)
 #if SIMTEMPERATURE
   return GhGetRandom(USTEMP - LSTEMP) + LSTEMP;
 #else
-  ht221sData_s ct = {0};
-  ct = ShGetHT221SData();
-  return ct.temperature;
+  return sensed[TEMPERATURE];
 #endif
 }
 
-/**  @brief Assign sensor values to readings variables.
- *   @version 9APR2021
+/**  @brief Assign sensor values to readings variables after passing each
+ * through its filter chain. Real sensors are read through the registry.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @return Current sensor values.
  */
 reading_s GhGetReadings(void)
 {
-  reading_s now = {0};
+  reading_s none = {0};
+
+  return GhUpdateReadings(none, READALL);
+}
+
+/**  @brief Sample some of the sensors, keeping the other readings. Only the
+ * sensor models feeding the requested channels are polled, and only their
+ * sample times are advanced.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param prev readings the unsampled channels are kept from.
+ *   @param channels bit (1 << TEMPERATURE), (1 << HUMIDITY) or
+ * (1 << PRESSURE) set for each channel to sample, READALL for every one.
+ *   @return readings stamped with the current time.
+ */
+reading_s GhUpdateReadings(reading_s prev, int channels)
+{
+  reading_s now = prev;
 
   now.rtime = time(NULL);
-  now.temperature = GhGetTemperature();
-  now.humidity = GhGetHumidity();
-  now.pressure = GhGetPressure();
+#if !(SIMTEMPERATURE && SIMHUMIDITY && SIMPRESSURE)
+  // Every bus is polled at once, the getters return the combined values
+  GhSensorsSample(sensed,
+                  (channels & ((1 << TEMPERATURE) | (1 << HUMIDITY))
+                       ? 1u << SENSORHTS221
+                       : 0) |
+                      (channels & (1 << PRESSURE) ? 1u << SENSORLPS25H : 0));
+#endif
+  if (channels & (1 << TEMPERATURE))
+  {
+    now.temperature = GhFilterSample(TEMPERATURE, GhGetTemperature());
+    sampled[TEMPERATURE] = now.rtime;
+  }
+  if (channels & (1 << HUMIDITY))
+  {
+    now.humidity = GhFilterSample(HUMIDITY, GhGetHumidity());
+    sampled[HUMIDITY] = now.rtime;
+  }
+  if (channels & (1 << PRESSURE))
+  {
+    now.pressure = GhFilterSample(PRESSURE, GhGetPressure());
+    sampled[PRESSURE] = now.rtime;
+  }
   return now;
 }
 
 /**  @brief Set heater and humidifier states to on or off based on set values.
- *   @version 9APR2021
+ * A missing reading turns its actuator off.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @param target Target envirinmental values which the controller must
  * maintain.
@@ -198,7 +283,7 @@ control_s GhSetControls(setpoint_s target, reading_s rdata)
 {
   control_s cset = {0};
 
-  if (rdata.temperature < target.temperature)
+  if (!isnan(rdata.temperature) && rdata.temperature < target.temperature)
   {
     cset.heater = ON;
   }
@@ -206,7 +291,7 @@ control_s GhSetControls(setpoint_s target, reading_s rdata)
   {
     cset.heater = OFF;
   }
-  if (rdata.humidity < target.humidity)
+  if (!isnan(rdata.humidity) && rdata.humidity < target.humidity)
   {
     cset.humidifier = ON;
   }
@@ -259,51 +344,110 @@ void GhDisplayControls(control_s ctrl)
           ctrl.humidifier);
 }
 
-/**  @brief Write output data into a file pointed to by fname.
- *   @version 9APR2021
+/**  @brief Write output data, tagged with the unit serial, into a file pointed
+ * to by fname and note the record in the log's time index.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @param fname points to a file which will hold output data.
  *   @param ghdata holds current time and sensor readings.
- *   @return 1 or 0 depending on the value returned by fopen.
+ *   @return 1 or 0 depending on whether the record was written.
  */
 int GhLogData(char *fname, reading_s ghdata)
 {
-  FILE *fp;
-  char ltime[CTIMESTRSZ];
-  fp = fopen(fname, "a");
-  if (fp == NULL)
+  return GhLogBatch(fname, &ghdata, 1);
+}
+
+/**  @brief Write up to LOGBATCH readings, tagged with the unit serial, into a
+ * file pointed to by fname and note each record in the log's time index. The
+ * records are formatted into one buffer and appended with a single write.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to a file which will hold output data.
+ *   @param rdata readings in time order.
+ *   @param n number of readings, at most LOGBATCH.
+ *   @return 1 or 0 depending on whether the records were written.
+ */
+int GhLogBatch(char *fname, const reading_s *rdata, int n)
+{
+  static logstamp_s stamp;                  // Only the controller thread logs
+  static char buf[LOGBATCH * LOGRECORDSZ];
+  static size_t at[LOGBATCH];               // Offset of each record in buf
+  double value[LOGFIELDS];
+  struct stat st;
+  size_t len = 0;
+  int fd, ok, i;
+
+  if (n < 1 || n > LOGBATCH)
   {
     return 0;
   }
-  strcpy(ltime, ctime(&ghdata.rtime));
-  ltime[3] = ',';
-  ltime[7] = ',';
-  ltime[10] = ',';
-  ltime[19] = ',';
-
-  fprintf(fp, "\n%.24s,%5.1lf,%5.1lf,%6.1lf", ltime, ghdata.temperature,
-          ghdata.humidity, ghdata.pressure);
-  fclose(fp);
+  fd = open(fname, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  if (fstat(fd, &st) == -1)
+  {
+    close(fd);
+    return 0;
+  }
+  for (i = 0; i < n; i++)
+  {
+    value[LOGTEMP] = rdata[i].temperature;
+    value[LOGHUMID] = rdata[i].humidity;
+    value[LOGPRESS] = rdata[i].pressure;
+    at[i] = len;
+    len += GhLogFormat(buf + len, &stamp, rdata[i].rtime, value,
+                       GhGetSerial());
+  }
+  ok = write(fd, buf, len) == (ssize_t)len;
+  if (close(fd) != 0 || !ok)
+  {
+    return 0;
+  }
+  for (i = 0; i < n; i++)
+  {
+    GhIndexNote(fname, GhLogLocal(rdata[i].rtime), st.st_size + (off_t)at[i]);
+  }
   return 1;
 }
 
-/**  @brief Write data from spts into a file pointed to by fname.
- *   @version 9APR2021
+/**  @brief Write data from spts into a temporary file, flush it to disk and
+ * rename it over the file pointed to by fname.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @param fname points to a file which will hold environmental constants.
- *   @param ghdata holds environmental constants.
- *   @return 1 or 0 depending on the value returned by fopen. 
+ *   @param spts holds environmental constants.
+ *   @return 1 or 0 depending on whether the file was replaced.
  */
 int GhSaveSetPoints(char *fname, setpoint_s spts)
 {
   FILE *fp;
-  fp = fopen(fname, "w");
+  char tmpname[SYSINFOBUFSZ];
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", fname);
+  fp = fopen(tmpname, "w");
   if (fp == NULL)
   {
     return 0;
   }
-  fwrite(&spts, sizeof(setpoint_s), 1, fp);
+  if (fwrite(&spts, sizeof(setpoint_s), 1, fp) != 1)
+  {
+    fclose(fp);
+    unlink(tmpname);
+    return 0;
+  }
+  if (fflush(fp) != 0 || fsync(fileno(fp)) != 0)
+  {
+    fclose(fp);
+    unlink(tmpname);
+    return 0;
+  }
   fclose(fp);
+  if (rename(tmpname, fname) != 0)
+  {
+    unlink(tmpname);
+    return 0;
+  }
   return 1;
 }
 
@@ -327,8 +471,9 @@ setpoint_s GhRetrieveSetPoints(char *fname)
   return spts;
 }
 
-/**  @brief Display scaled sensor readings and targets on LED matrix.
- *   @version 9APR2021
+/**  @brief Display scaled sensor readings and targets on LED matrix. The bar
+ * of a missing reading is left dark.
+ *   @version 19OCT2026
  *   @author Caio Cotts
  *   @param rd current sensor readings.
  *   @param sd current environmental constants.
@@ -339,20 +484,29 @@ void GhDisplayAll(reading_s rd, setpoint_s sd)
   int rv, sv, avh, avl;
   fbpixel_s pxc = {0};
   ShClearMatrix();
-  rv =
-      (NUMPTS * (((rd.temperature - LSTEMP) / (USTEMP - LSTEMP)) + 0.05)) - 1.0;
   pxc.red = 0x00;
   pxc.green = 0xFF;
   pxc.blue = 0x00;
-  ShSetVerticalBar(TBAR, pxc, rv);
+  if (!isnan(rd.temperature))
+  {
+    rv = (NUMPTS * (((rd.temperature - LSTEMP) / (USTEMP - LSTEMP)) + 0.05)) -
+         1.0;
+    ShSetVerticalBar(TBAR, pxc, rv);
+  }
 
-  rv =
-      (NUMPTS * (((rd.humidity - LSHUMID) / (USHUMID - LSHUMID)) + 0.05)) - 1.0;
-  ShSetVerticalBar(HBAR, pxc, rv);
+  if (!isnan(rd.humidity))
+  {
+    rv = (NUMPTS * (((rd.humidity - LSHUMID) / (USHUMID - LSHUMID)) + 0.05)) -
+         1.0;
+    ShSetVerticalBar(HBAR, pxc, rv);
+  }
 
-  rv =
-      (NUMPTS * (((rd.pressure - LSPRESS) / (USPRESS - LSPRESS)) + 0.05)) - 1.0;
-  ShSetVerticalBar(PBAR, pxc, rv);
+  if (!isnan(rd.pressure))
+  {
+    rv = (NUMPTS * (((rd.pressure - LSPRESS) / (USPRESS - LSPRESS)) + 0.05)) -
+         1.0;
+    ShSetVerticalBar(PBAR, pxc, rv);
+  }
 
   sv =
       (NUMPTS * (((sd.temperature - LSTEMP) / (USTEMP - LSTEMP)) + 0.05)) - 1.0;
@@ -380,49 +534,196 @@ alarmlimit_s GhSetAlarmLimits(void)
   calarm.lowh = LOWERAHUMID;
   calarm.highp = UPPERAPRESS;
   calarm.lowp = LOWERAPRESS;
+  calarm.hystt = HYSTATEMP;
+  calarm.hysth = HYSTAHUMID;
+  calarm.hystp = HYSTAPRESS;
+  calarm.ratet = RATEATEMP;
+  calarm.rateh = RATEAHUMID;
+  calarm.ratep = RATEAPRESS;
+  calarm.debounce = ALARMDEBOUNCE;
   return calarm;
 }
 
-/**  @brief Set alarms on or of depending one current sensor readings.
- *   @version 9APR2021
+/**  @brief Check whether an alarm is in the linked list.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param code alarm code to look for.
+ *   @param head the first element in the linked list.
+ *   @return 1 if the alarm is active, 0 otherwise.
+ */
+int GhAlarmActive(alarm_e code, alarm_s *head)
+{
+  alarm_s *cur;
+
+  for (cur = head; cur != NULL; cur = cur->next)
+  {
+    if (cur->code == code)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**  @brief Pass an alarm raise or clear to everything that records alarm
+ * history, and queue a notice for it.
+ *   @version 19OCT2026
  *   @author Caio Cotts
- *   @param calarm array holding alarm states.
- *   @param alarmpt alarm limits.
- *   @param radata current sensor readings and time.
+ *   @param code alarm code.
+ *   @param type ALARMRAISE or ALARMCLEAR.
+ *   @param etime time of the event.
+ *   @param value reading that caused the event.
  *   @return void
  */
-alarm_s *GhSetAlarms(alarm_s *head, alarmlimit_s salarmpt, reading_s srdata)
+void GhAlarmEvent(alarm_e code, alarmevent_e type, time_t etime, double value)
 {
+  GhJournalRecord(code, type, etime, value);
+  GhNotifyPost(code, alarmnames[code], type, etime, value);
+}
 
-  if (srdata.temperature >= salarmpt.hight)
+/**  @brief Raise or clear one alarm once its condition has held for the
+ * debounce time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param head the first element in the linked list.
+ *   @param code alarm code.
+ *   @param raise set while the reading is past the alarm limit.
+ *   @param clear set while the reading is back inside the hysteresis band.
+ *   @param rtime time of the reading.
+ *   @param value reading stored with the alarm.
+ *   @param debounce seconds the condition must hold.
+ *   @return pointer to head of the linked list.
+ */
+static alarm_s *GhAlarmUpdate(alarm_s *head, alarm_e code, int raise, int clear,
+                              time_t rtime, double value, int debounce)
+{
+  int active = GhAlarmActive(code, head);
+
+  if (!(active ? clear : raise))
   {
-    GhSetOneAlarm(HTEMP, srdata.rtime, srdata.temperature, head);
+    atrack[code].since = 0;
+    return head;
   }
-  else
+  if (atrack[code].since == 0)
   {
-    head = GhClearOneAlarm(HTEMP, head);
+    atrack[code].since = rtime;
   }
+  if (rtime - atrack[code].since < debounce)
+  {
+    return head;
+  }
+  atrack[code].since = 0;
+  if (active)
+  {
+    head = GhClearOneAlarm(code, head);
+    GhAlarmEvent(code, ALARMCLEAR, rtime, value);
+  }
+  else if (GhSetOneAlarm(code, rtime, value, head))
+  {
+    GhAlarmEvent(code, ALARMRAISE, rtime, value);
+  }
+  return head;
+}
 
-  if (srdata.humidity >= salarmpt.highh)
+/**  @brief Update the smoothed rate of change of one sensor. The slope is
+ * taken over at least RATEWINDOW seconds, so a step of sensor noise between
+ * two close readings does not read as a fast change.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rt rate state of the sensor.
+ *   @param rtime time of the reading.
+ *   @param value the reading.
+ *   @return smoothed change per minute.
+ */
+static double GhAlarmRate(ratetrack_s *rt, time_t rtime, double value)
+{
+  double slope;
+
+  if (rt->rtime == 0 || rtime < rt->rtime)
   {
-    GhSetOneAlarm(HHUMID, srdata.rtime, srdata.humidity, head);
+    rt->rtime = rtime;
+    rt->value = value;
+    rt->rate = 0.0;
   }
-  else
+  else if (rtime - rt->rtime >= RATEWINDOW)
   {
-    head = GhClearOneAlarm(HHUMID, head);
+    slope = (value - rt->value) * 60.0 / (double)(rtime - rt->rtime);
+    rt->rate = RATEALPHA * slope + (1.0 - RATEALPHA) * rt->rate;
+    rt->rtime = rtime;
+    rt->value = value;
   }
+  return rt->rate;
+}
+
+/**  @brief Set alarms on or of depending one current sensor readings. Level
+ * alarms clear only once the reading is back inside the limit by the
+ * hysteresis band, rate alarms once the rate falls to a fraction of its limit.
+ * The alarms of a missing reading keep their state, and its rate starts over
+ * when the reading returns. Each rate is timed by when its own sensor was
+ * last sampled, so it only moves when that sensor is resampled.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param head the first element in the linked list.
+ *   @param salarmpt alarm limits.
+ *   @param srdata current sensor readings and time.
+ *   @return pointer to head of the linked list.
+ */
+alarm_s *GhSetAlarms(alarm_s *head, alarmlimit_s salarmpt, reading_s srdata)
+{
+  const double rlimit[SENSORS] = {salarmpt.ratet, salarmpt.rateh,
+                                  salarmpt.ratep};
+  const double rvalue[SENSORS] = {srdata.temperature, srdata.humidity,
+                                  srdata.pressure};
+  time_t t = srdata.rtime;
+  int db = salarmpt.debounce;
+  double rate;
+  int i;
 
-  if (srdata.pressure >= salarmpt.highp)
+  if (!isnan(srdata.temperature))
   {
-    GhSetOneAlarm(HPRESS, srdata.rtime, srdata.pressure, head);
+    head = GhAlarmUpdate(head, HTEMP, srdata.temperature >= salarmpt.hight,
+                         srdata.temperature < salarmpt.hight - salarmpt.hystt,
+                         t, srdata.temperature, db);
+    head = GhAlarmUpdate(head, LTEMP, srdata.temperature <= salarmpt.lowt,
+                         srdata.temperature > salarmpt.lowt + salarmpt.hystt,
+                         t, srdata.temperature, db);
   }
-  else
+  if (!isnan(srdata.humidity))
   {
-    head = GhClearOneAlarm(HPRESS, head);
+    head = GhAlarmUpdate(head, HHUMID, srdata.humidity >= salarmpt.highh,
+                         srdata.humidity < salarmpt.highh - salarmpt.hysth, t,
+                         srdata.humidity, db);
+    head = GhAlarmUpdate(head, LHUMID, srdata.humidity <= salarmpt.lowh,
+                         srdata.humidity > salarmpt.lowh + salarmpt.hysth, t,
+                         srdata.humidity, db);
+  }
+  if (!isnan(srdata.pressure))
+  {
+    head = GhAlarmUpdate(head, HPRESS, srdata.pressure >= salarmpt.highp,
+                         srdata.pressure < salarmpt.highp - salarmpt.hystp, t,
+                         srdata.pressure, db);
+    head = GhAlarmUpdate(head, LPRESS, srdata.pressure <= salarmpt.lowp,
+                         srdata.pressure > salarmpt.lowp + salarmpt.hystp, t,
+                         srdata.pressure, db);
+  }
+
+  for (i = 0; i < SENSORS; i++)
+  {
+    if (isnan(rvalue[i]))
+    {
+      rtrack[i].rtime = 0;
+      continue;
+    }
+    rate = fabs(GhAlarmRate(&rtrack[i], sampled[i] != 0 ? sampled[i] : t,
+                            rvalue[i]));
+    head = GhAlarmUpdate(head, RTEMP + i, rlimit[i] > 0.0 && rate >= rlimit[i],
+                         rlimit[i] <= 0.0 || rate <= rlimit[i] * RATECLEAR, t,
+                         rate, db);
   }
 
   return head;
 }
+
 /**  @brief Display active alarms.
  *   @version 9APR2021
  *   @author Caio Cotts
@@ -431,41 +732,58 @@ alarm_s *GhSetAlarms(alarm_s *head, alarmlimit_s salarmpt, reading_s srdata)
  */
 void GhDisplayAlarms(alarm_s *head)
 {
+  static logstamp_s stamp;
   alarm_s *cur;
   cur = head;
   puts("\nAlarms");
 
   while (cur != NULL)
   {
-    if (cur->code == HTEMP)
-    {
-      printf("%s %s", alarmnames[HTEMP], ctime(&cur->atime));
-    }
-    else if (cur->code == LTEMP)
-    {
-      printf("%s %s", alarmnames[LTEMP], ctime(&cur->atime));
-    }
-    if (cur->code == HHUMID)
-    {
-      printf("%s %s", alarmnames[HHUMID], ctime(&cur->atime));
-    }
-    else if (cur->code == LHUMID)
+    if (cur->code > NOALARM && cur->code < NALARMS)
     {
-      printf("%s %s", alarmnames[LHUMID], ctime(&cur->atime));
-    }
-    if (cur->code == HPRESS)
-    {
-      printf("%s %s", alarmnames[HPRESS], ctime(&cur->atime));
-    }
-    else if (cur->code == LPRESS)
-    {
-      printf("%s %s", alarmnames[LPRESS], ctime(&cur->atime));
+      printf("%s %s\n", alarmnames[cur->code],
+             GhLogStamp(&stamp, cur->atime));
     }
 
     cur = cur->next;
   }
 }
 
+/**  @brief Allocate a zeroed alarm list node. With GHSTATIC the node comes
+ * from a pool sized for one node per alarm code, created on first use during
+ * startup.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return the node, NULL if none is available.
+ */
+alarm_s *GhAlarmNew(void)
+{
+#if GHSTATIC
+  if (alarmpool == NULL)
+  {
+    alarmpool = GhPoolCreate("alarms", sizeof(alarm_s), NALARMS);
+  }
+  return GhPoolAlloc(alarmpool);
+#else
+  return calloc(1, sizeof(alarm_s));
+#endif
+}
+
+/**  @brief Release an alarm list node.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param node node from GhAlarmNew.
+ *   @return void
+ */
+void GhAlarmDelete(alarm_s *node)
+{
+#if GHSTATIC
+  GhPoolFree(alarmpool, node);
+#else
+  free(node);
+#endif
+}
+
 /**  @brief Set the alarm code for one alarm in a linked list.
  *   @version 9APR2021
  *   @author Caio Cotts
@@ -499,7 +817,11 @@ int GhSetOneAlarm(alarm_e code, time_t atime, double value, alarm_s *head)
     cur->next = NULL;
     return 1;
   }
-  cur = (alarm_s *)calloc(1, sizeof(alarm_s));
+  cur = GhAlarmNew();
+  if (cur == NULL)
+  {
+    return 0;
+  }
   last->next = cur;
   cur->code = code;
   cur->atime = atime;
@@ -528,7 +850,7 @@ alarm_s *GhClearOneAlarm(alarm_e code, alarm_s *head)
   if (cur->code == code && cur->next != NULL)
   {
     head = cur->next;
-    free(cur);
+    GhAlarmDelete(cur);
     return head;
   }
   while (cur != NULL)
@@ -536,7 +858,7 @@ alarm_s *GhClearOneAlarm(alarm_e code, alarm_s *head)
     if (cur->code == code)
     {
       last->next = cur->next;
-      free(cur);
+      GhAlarmDelete(cur);
       return head;
     }
     last = cur;
@@ -544,3 +866,159 @@ alarm_s *GhClearOneAlarm(alarm_e code, alarm_s *head)
   }
   return head;
 }
+
+/**  @brief Copy the active alarms of a linked list into fixed size records.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param head the first element in the linked list.
+ *   @param recs array receiving the alarm records.
+ *   @param max number of elements in recs.
+ *   @return number of records written.
+ */
+int GhAlarmRecords(alarm_s *head, alarmrecord_s *recs, int max)
+{
+  alarm_s *cur;
+  int n = 0;
+
+  for (cur = head; cur != NULL && n < max; cur = cur->next)
+  {
+    if (cur->code == NOALARM)
+    {
+      continue;
+    }
+    recs[n].code = cur->code;
+    recs[n].reserved = 0;
+    recs[n].atime = cur->atime;
+    recs[n].value = cur->value;
+    n++;
+  }
+  return n;
+}
+
+/**  @brief Fill a snapshot with the current controller values.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap snapshot to fill, the cycle counter is advanced.
+ *   @param rdata current sensor readings.
+ *   @param spts current setpoints.
+ *   @param ctrl current heater and humidifier states.
+ *   @param head the first element in the alarm linked list.
+ *   @return void
+ */
+void GhSnapshotFill(snapshot_s *snap, reading_s rdata, setpoint_s spts,
+                    control_s ctrl, alarm_s *head)
+{
+  snap->serial = GhGetSerial();
+  snap->cycles++;
+  snap->reading = rdata;
+  snap->spts = spts;
+  snap->ctrl = ctrl;
+  snap->nalarms = GhAlarmRecords(head, snap->alarms, NALARMS);
+}
+
+/**  @brief Build the Arrow export row of a snapshot.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap filled snapshot.
+ *   @return row with one alarms bit set per active alarm code.
+ */
+arrowrow_s GhSnapshotRow(const snapshot_s *snap)
+{
+  arrowrow_s row = {0};
+  uint32_t i;
+
+  row.ltime = GhLogLocal(snap->reading.rtime);
+  row.unit = snap->serial;
+  row.value[LOGTEMP] = snap->reading.temperature;
+  row.value[LOGHUMID] = snap->reading.humidity;
+  row.value[LOGPRESS] = snap->reading.pressure;
+  row.actuators = 1;
+  row.heater = snap->ctrl.heater;
+  row.humidifier = snap->ctrl.humidifier;
+  for (i = 0; i < snap->nalarms; i++)
+  {
+    row.alarms |= 1u << snap->alarms[i].code;
+  }
+  return row;
+}
+
+/**  @brief Fraction of the alarm band left between a value and its nearest
+ * limit, 0 at or beyond a limit and 0.5 in the middle of the band. A missing
+ * value counts as the middle of the band.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param value current reading.
+ *   @param low lower alarm limit.
+ *   @param high upper alarm limit.
+ *   @return margin as a fraction of the band.
+ */
+static double GhSampleMargin(double value, double low, double high)
+{
+  double span = high - low, margin;
+
+  if (span <= 0)
+  {
+    return 0;
+  }
+  if (isnan(value))
+  {
+    return 0.5;
+  }
+  margin = (value - low) < (high - value) ? value - low : high - value;
+  return margin <= 0 ? 0 : margin / span;
+}
+
+/**  @brief Choose the delay before the next reading. Sampling drops to the
+ * fastest rate when a reading is close to an alarm limit or moving quickly,
+ * and backs off gradually toward the slowest rate while readings are steady.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rdata current sensor readings.
+ *   @param prev previous sensor readings, rtime 0 if there are none.
+ *   @param alimits alarm limits.
+ *   @param current delay used for the last cycle in milliseconds.
+ *   @param mindelay fastest sampling delay in milliseconds.
+ *   @param maxdelay slowest sampling delay in milliseconds.
+ *   @return delay for the next cycle in milliseconds.
+ */
+int GhSampleDelay(reading_s rdata, reading_s prev, alarmlimit_s alimits,
+                  int current, int mindelay, int maxdelay)
+{
+  double margin, rate = 0, dt;
+  int next;
+
+  margin = GhSampleMargin(rdata.temperature, alimits.lowt, alimits.hight);
+  if (GhSampleMargin(rdata.humidity, alimits.lowh, alimits.highh) < margin)
+  {
+    margin = GhSampleMargin(rdata.humidity, alimits.lowh, alimits.highh);
+  }
+  if (GhSampleMargin(rdata.pressure, alimits.lowp, alimits.highp) < margin)
+  {
+    margin = GhSampleMargin(rdata.pressure, alimits.lowp, alimits.highp);
+  }
+
+  // Largest change per minute as a fraction of each alarm band
+  dt = difftime(rdata.rtime, prev.rtime);
+  if (prev.rtime != 0 && dt > 0)
+  {
+    double rt = fabs(rdata.temperature - prev.temperature) /
+                (alimits.hight - alimits.lowt);
+    double rh =
+        fabs(rdata.humidity - prev.humidity) / (alimits.highh - alimits.lowh);
+    double rp =
+        fabs(rdata.pressure - prev.pressure) / (alimits.highp - alimits.lowp);
+    // fmax passes over the change of a missing reading
+    rate = fmax(fmax(rt, rh), rp) * 60.0 / dt;
+  }
+
+  if (margin < SAMPLENEAR || rate > SAMPLEFAST)
+  {
+    next = mindelay;
+  }
+  else
+  {
+    next = current * SAMPLEBACKOFF;
+    next = next < mindelay ? mindelay : next;
+  }
+  return next > maxdelay ? maxdelay : next;
+}
@@ -3,6 +3,9 @@
  */
 #ifndef GHCONTROL_H
 #define GHCONTROL_H
+#include "ghalarmnames.h"
+#include "gharrow.h"
+#include "ghjournal.h"
 #include "pisensehat.h"
 #include <stdint.h>
 #include <time.h>
@@ -10,10 +13,16 @@
 #define SEARCHSTR "serial\t\t: "
 #define SYSINFOBUFSZ 512
 #define GHUPDATE 2000
-#define SENSORS 3     // not used
-#define TEMPERATURE 0 // not used
-#define HUMIDITY 1    // not used
-#define PRESSURE 2    // not used
+#define GHUPDATEMIN 500
+#define GHUPDATEMAX 30000
+#define SAMPLENEAR 0.1    // band fraction from a limit that samples fastest
+#define SAMPLEFAST 0.05   // band fraction per minute that samples fastest
+#define SAMPLEBACKOFF 1.5 // growth of the delay per steady cycle
+#define SENSORS 3
+#define TEMPERATURE 0
+#define HUMIDITY 1
+#define PRESSURE 2
+#define READALL ((1 << TEMPERATURE) | (1 << HUMIDITY) | (1 << PRESSURE))
 #define SIMULATE 1    // not used
 #define USTEMP 50
 #define LSTEMP -10
@@ -35,14 +44,22 @@
 #define HBAR 5
 #define PBAR 3
 #define SENSEHAT 1
-#define NALARMS 7
 #define LOWERATEMP 10
 #define UPPERATEMP 30
 #define LOWERAHUMID 25
 #define UPPERAHUMID 70
 #define LOWERAPRESS 985
 #define UPPERAPRESS 1016
-#define ALARMNMSZ 18
+#define HYSTATEMP 0.5    // degrees back inside a limit before the alarm clears
+#define HYSTAHUMID 2.0
+#define HYSTAPRESS 1.0
+#define RATEATEMP 2.0    // degrees per minute, 0 disables the rate alarm
+#define RATEAHUMID 10.0
+#define RATEAPRESS 2.0
+#define RATEALPHA 0.5    // weight of the newest slope in the smoothed rate
+#define RATEWINDOW 30    // shortest interval in seconds a slope is taken over
+#define RATECLEAR 0.5    // fraction of the rate limit a rate alarm clears at
+#define ALARMDEBOUNCE 4  // seconds a condition must hold to raise or clear
 
 typedef struct readings
 {
@@ -70,7 +87,10 @@ typedef enum
   HHUMID,
   LHUMID,
   HPRESS,
-  LPRESS
+  LPRESS,
+  RTEMP,
+  RHUMID,
+  RPRESS
 } alarm_e;
 
 typedef struct alarmlimits
@@ -81,6 +101,13 @@ typedef struct alarmlimits
   double lowh;
   double highp;
   double lowp;
+  double hystt;
+  double hysth;
+  double hystp;
+  double ratet;
+  double rateh;
+  double ratep;
+  int debounce;
 } alarmlimit_s;
 typedef struct alarms
 {
@@ -89,12 +116,35 @@ typedef struct alarms
   double value;
   struct alarms *next;
 } alarm_s;
+typedef struct alarmrecord
+{
+  int32_t code;
+  int32_t reserved;
+  int64_t atime;
+  double value;
+} alarmrecord_s;
+typedef struct snapshot
+{
+  uint64_t serial;
+  uint64_t cycles;
+  reading_s reading;
+  setpoint_s spts;
+  control_s ctrl;
+  uint64_t cycleus;
+  uint64_t maxcycleus;
+  uint64_t logerrors;
+  uint64_t configerrors;
+  uint32_t nalarms;
+  uint32_t samplems;
+  alarmrecord_s alarms[NALARMS];
+} snapshot_s;
 
 ///@cond INTERNAL
 int GhGetRandom(int range);
 uint64_t GhGetSerial(void);
 void GhDisplayHeader(const char *sname);
 void GhDelay(int milliseconds);
+uint64_t GhClockMicros(void);
 void GhControllerInit(void);
 void GhDisplayControls(control_s ctrl);
 void GhDisplayReadings(reading_s rdata);
@@ -105,7 +155,9 @@ double GhGetHumidity(void);
 double GhGetPressure(void);
 double GhGetTemperature(void);
 reading_s GhGetReadings(void);
+reading_s GhUpdateReadings(reading_s prev, int channels);
 int GhLogData(char *fname, reading_s ghdata);
+int GhLogBatch(char *fname, const reading_s *rdata, int n);
 int GhSaveSetPoints(char *fname, setpoint_s spts);
 setpoint_s GhRetrieveSetPoints(char *fname);
 void GhDisplayAll(reading_s rd, setpoint_s sd);
@@ -115,6 +167,16 @@ alarm_s *GhSetAlarms(alarm_s *head, alarmlimit_s salarmpt,
 void GhDisplayAlarms(alarm_s *head);
 int GhSetOneAlarm(alarm_e code, time_t atime, double value, alarm_s *head);
 alarm_s *GhClearOneAlarm(alarm_e code, alarm_s *head);
+alarm_s *GhAlarmNew(void);
+void GhAlarmDelete(alarm_s *node);
+int GhAlarmActive(alarm_e code, alarm_s *head);
+void GhAlarmEvent(alarm_e code, alarmevent_e type, time_t etime, double value);
+int GhAlarmRecords(alarm_s *head, alarmrecord_s *recs, int max);
+int GhSampleDelay(reading_s rdata, reading_s prev, alarmlimit_s alimits,
+                  int current, int mindelay, int maxdelay);
+void GhSnapshotFill(snapshot_s *snap, reading_s rdata, setpoint_s spts,
+                    control_s ctrl, alarm_s *head);
+arrowrow_s GhSnapshotRow(const snapshot_s *snap);
 ///@endcond
 
 #endif
\ No newline at end of file
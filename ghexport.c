@@ -0,0 +1,88 @@
+/**  @brief Export ghdata.txt logs as one Apache Arrow IPC file. Readings are
+ * exported with their unit, actuator and alarm columns are null because the
+ * text log does not record them. Inputs may be gzipped rotated segments.
+ *   @file ghexport.c
+ */
+#include "gharrow.h"
+#include "ghlog.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define EXPORTFILE "ghdata.arrow"
+#define EXPORTLINESZ 128
+
+int main(int argc, char *argv[])
+{
+  const char *outname = EXPORTFILE;
+  unsigned long long written = 0;
+  char line[EXPORTLINESZ];
+  logrecord_s rec;
+  arrowrow_s row = {0};
+  gzFile gz;
+  size_t len;
+  int opt, i, j;
+
+  while ((opt = getopt(argc, argv, "o:")) != -1)
+  {
+    if (opt != 'o')
+    {
+      fprintf(stderr, "usage: %s [-o output] [logfile...]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+    outname = optarg;
+  }
+  if (optind == argc)
+  {
+    argv[argc++] = GHDATAFILE;
+  }
+  if (!GhArrowOpen(outname, ARROWBATCHMAX, 0))
+  {
+    perror(outname);
+    return EXIT_FAILURE;
+  }
+
+  for (i = optind; i < argc; i++)
+  {
+    gz = gzopen(argv[i], "rb");
+    if (gz == NULL)
+    {
+      perror(argv[i]);
+      return EXIT_FAILURE;
+    }
+    gzbuffer(gz, 16384);
+    while (gzgets(gz, line, sizeof(line)) != NULL)
+    {
+      len = strcspn(line, "\r\n");
+      line[len] = '\0';
+      if (!GhLogParseLine(line, len, &rec))
+      {
+        continue;
+      }
+      row.ltime = rec.ltime;
+      row.unit = rec.unit;
+      for (j = 0; j < LOGFIELDS; j++)
+      {
+        row.value[j] = rec.value[j] == LOGMISSING ? NAN : rec.value[j] / 10.0;
+      }
+      if (!GhArrowAppend(&row))
+      {
+        fprintf(stderr, "%s: write failed\n", outname);
+        return EXIT_FAILURE;
+      }
+      written++;
+    }
+    gzclose(gz);
+  }
+
+  if (!GhArrowClose())
+  {
+    fprintf(stderr, "%s: write failed\n", outname);
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%llu records from %d logs\n", written, argc - optind);
+  return EXIT_SUCCESS;
+}
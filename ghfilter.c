@@ -0,0 +1,167 @@
+/**  @brief Code for the streaming filters applied to each sensor reading:
+ * outlier rejection on rolling variance, a sliding median and an EWMA
+ *   @file ghfilter.c
+ */
+#include "ghfilter.h"
+#include <math.h>
+#include <string.h>
+
+static filterconfig_s fconfig = {FILTERALPHA, FILTERMEDIAN, FILTERSIGMA};
+static filterstate_s fstate[FILTERSENSORS]; // One filter chain per sensor
+
+/**  @brief Replace the filter settings, restarting any median window whose
+ * size changed.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cfg new filter settings.
+ *   @return void
+ */
+void GhFilterSetup(filterconfig_s cfg)
+{
+  int i;
+
+  if (cfg.median != fconfig.median)
+  {
+    for (i = 0; i < FILTERSENSORS; i++)
+    {
+      fstate[i].wpos = 0;
+      fstate[i].wcount = 0;
+    }
+  }
+  fconfig = cfg;
+}
+
+/**  @brief Slide the median window by one sample. The sorted copy is updated
+ * by removing the oldest sample and inserting the new one, at most
+ * FILTERWINDOW moves each.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fs filter state of the sensor.
+ *   @param x new sample.
+ *   @param size window size.
+ *   @return median of the window.
+ */
+static double GhFilterMedian(filterstate_s *fs, double x, int size)
+{
+  int i;
+
+  if (fs->wcount == size)
+  {
+    double old = fs->window[fs->wpos];
+    for (i = 0; i < fs->wcount && fs->sorted[i] != old; i++)
+      ;
+    for (; i < fs->wcount - 1; i++)
+    {
+      fs->sorted[i] = fs->sorted[i + 1];
+    }
+    fs->wcount--;
+  }
+  fs->window[fs->wpos] = x;
+  fs->wpos = (fs->wpos + 1) % size;
+  for (i = fs->wcount; i > 0 && fs->sorted[i - 1] > x; i--)
+  {
+    fs->sorted[i] = fs->sorted[i - 1];
+  }
+  fs->sorted[i] = x;
+  fs->wcount++;
+  return fs->sorted[fs->wcount / 2];
+}
+
+/**  @brief Pass one raw sample through the filter chain of a sensor. A
+ * missing sample, NAN, holds the last output for up to FILTERHOLD samples,
+ * after that and before any real sample the output is NAN as well.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param sensor sensor number, 0 to FILTERSENSORS - 1.
+ *   @param x raw sample.
+ *   @return filtered value, NAN while the sensor is missing.
+ */
+double GhFilterSample(int sensor, double x)
+{
+  filterstate_s *fs = &fstate[sensor];
+  double dev, m;
+
+  if (x != x)
+  {
+    // Ride out a short dropout, then report the sensor as missing
+    fs->missing++;
+    if (fs->seen == 0 || fs->missrun >= FILTERHOLD)
+    {
+      return NAN;
+    }
+    fs->missrun++;
+    return fs->ewma;
+  }
+  fs->missrun = 0;
+
+  if (fs->seen == 0)
+  {
+    fs->mean = fs->ewma = x;
+    fs->var = 0.0;
+  }
+
+  // Outlier rejection against the rolling mean and variance
+  dev = sqrt(fs->var);
+  if (dev < FILTERMINDEV)
+  {
+    dev = FILTERMINDEV;
+  }
+  if (fconfig.sigma > 0.0 && fs->seen >= FILTERPRIME &&
+      fabs(x - fs->mean) > fconfig.sigma * dev &&
+      fs->rejectrun < FILTERMAXREJECT)
+  {
+    fs->rejectrun++;
+    fs->rejected++;
+    return fs->ewma;
+  }
+  fs->rejectrun = 0;
+  m = x - fs->mean;
+  fs->mean += FILTERVARALPHA * m;
+  fs->var = (1.0 - FILTERVARALPHA) * (fs->var + FILTERVARALPHA * m * m);
+  if (fs->seen < FILTERPRIME)
+  {
+    fs->seen++;
+  }
+
+  if (fconfig.median > 1)
+  {
+    x = GhFilterMedian(fs, x, fconfig.median);
+  }
+  fs->ewma = fs->seen == 1
+                 ? x
+                 : fconfig.alpha * x + (1.0 - fconfig.alpha) * fs->ewma;
+  return fs->ewma;
+}
+
+/**  @brief Copy the filter state of every sensor, for the state file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param st array of FILTERSENSORS states receiving the copy.
+ *   @return void
+ */
+void GhFilterExport(filterstate_s *st)
+{
+  memcpy(st, fstate, sizeof(fstate));
+}
+
+/**  @brief Restore the filter state of every sensor after a restart.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param st array of FILTERSENSORS states to restore.
+ *   @return void
+ */
+void GhFilterImport(const filterstate_s *st)
+{
+  int i;
+
+  memcpy(fstate, st, sizeof(fstate));
+  for (i = 0; i < FILTERSENSORS; i++)
+  {
+    if (fstate[i].wcount < 0 || fstate[i].wcount > fconfig.median ||
+        fstate[i].wpos < 0 || fstate[i].wpos >= fconfig.median)
+    {
+      fstate[i].wpos = 0;
+      fstate[i].wcount = 0;
+    }
+  }
+}
@@ -0,0 +1,49 @@
+/**  @brief Sensor reading filter constants, structures, function prototypes
+ *   @file ghfilter.h
+ */
+#ifndef GHFILTER_H
+#define GHFILTER_H
+#include <stdint.h>
+
+#define FILTERSENSORS 3    // temperature, humidity, pressure
+#define FILTERWINDOW 7     // largest median window
+#define FILTERALPHA 0.5    // EWMA weight of the newest sample, 1 disables
+#define FILTERMEDIAN 3     // median window, 1 disables
+#define FILTERSIGMA 4.0    // deviations that mark an outlier, 0 disables
+#define FILTERVARALPHA 0.1 // weight of the newest sample in mean and variance
+#define FILTERMINDEV 0.5   // smallest deviation used for outlier rejection
+#define FILTERMAXREJECT 3  // consecutive outliers accepted as a real step
+#define FILTERPRIME 8      // samples seen before outliers are rejected
+#define FILTERHOLD 3       // missing samples the last output is held for
+
+typedef struct filterconfig
+{
+  double alpha; // EWMA weight of the newest sample
+  int median;   // odd median window, 1 to FILTERWINDOW
+  double sigma; // outlier threshold in rolling deviations
+} filterconfig_s;
+
+typedef struct filterstate
+{
+  double window[FILTERWINDOW]; // last samples in arrival order
+  double sorted[FILTERWINDOW]; // the same samples kept in sorted order
+  int32_t wpos;                // next slot of window to overwrite
+  int32_t wcount;              // samples in the window
+  int32_t seen;                // samples accepted, saturates at FILTERPRIME
+  int32_t rejectrun;           // consecutive samples rejected
+  int32_t missrun;             // consecutive samples missing
+  double mean;                 // rolling mean of accepted samples
+  double var;                  // rolling variance of accepted samples
+  double ewma;                 // filter output
+  uint64_t rejected;           // samples rejected as outliers
+  uint64_t missing;            // samples missing, read as NAN
+} filterstate_s;
+
+///@cond INTERNAL
+void GhFilterSetup(filterconfig_s cfg);
+double GhFilterSample(int sensor, double x);
+void GhFilterExport(filterstate_s *st);
+void GhFilterImport(const filterstate_s *st);
+///@endcond
+
+#endif
@@ -0,0 +1,417 @@
+/**  @brief Code for the in-memory reading history. Recent samples are kept at
+ * full resolution and older ones folded into minute and hour buckets, all in
+ * preallocated rings, so trends and windowed queries never touch the log
+ *   @file ghhistory.c
+ */
+#include "ghhistory.h"
+#include <math.h>
+#include <string.h>
+
+typedef struct histring
+{
+  char *base;  // first entry
+  size_t size; // bytes per entry
+  int cap;     // entries in use as the ring
+  int head;    // position of the oldest entry
+  int count;   // entries held
+} histring_s;
+
+static histsample_s samples[HISTSAMPLESMAX]; // Full resolution samples
+static histbucket_s minutes[HISTMINUTES];    // One minute buckets
+static histbucket_s hours[HISTHOURS];        // One hour buckets
+static histring_s rings[1 + HISTTIERS] = {
+    {(char *)samples, sizeof(histsample_s), HISTSAMPLES, 0, 0},
+    {(char *)minutes, sizeof(histbucket_s), HISTMINUTES, 0, 0},
+    {(char *)hours, sizeof(histbucket_s), HISTHOURS, 0, 0}};
+static const int spans[HISTTIERS] = {60, 3600}; // Seconds per bucket
+static uint64_t added = 0; // Full resolution samples ever added
+
+/**  @brief Address of an entry counted from the oldest.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ring ring holding the entry.
+ *   @param i entry number, 0 is the oldest.
+ *   @return the entry.
+ */
+static char *GhHistoryEntry(const histring_s *ring, int i)
+{
+  return ring->base + (size_t)((ring->head + i) % ring->cap) * ring->size;
+}
+
+/**  @brief Take the slot for a new entry, dropping the oldest when full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ring ring to add to.
+ *   @return the slot, still holding whatever was there.
+ */
+static char *GhHistoryPush(histring_s *ring)
+{
+  if (ring->count < ring->cap)
+  {
+    return GhHistoryEntry(ring, ring->count++);
+  }
+  ring->head = (ring->head + 1) % ring->cap;
+  return GhHistoryEntry(ring, ring->count - 1);
+}
+
+/**  @brief Find the first entry at or after a time. Entries are in time order
+ * and every entry type starts with its time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ring ring to search.
+ *   @param t time to look for.
+ *   @return entry number, ring->count if every entry is older.
+ */
+static int GhHistoryLower(const histring_s *ring, time_t t)
+{
+  int lo = 0, hi = ring->count, mid;
+
+  while (lo < hi)
+  {
+    mid = (lo + hi) / 2;
+    if (*(const time_t *)GhHistoryEntry(ring, mid) < t)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+/**  @brief Split the entries in a time window into at most two runs that are
+ * contiguous in memory, oldest first.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ring ring to search.
+ *   @param from window start.
+ *   @param to window end, exclusive.
+ *   @param part receives the start of each run.
+ *   @param n receives the length of each run.
+ *   @return number of entries in the window.
+ */
+static int GhHistorySlice(const histring_s *ring, time_t from, time_t to,
+                          const char *part[2], int n[2])
+{
+  int lo = GhHistoryLower(ring, from);
+  int hi = GhHistoryLower(ring, to);
+  int first = (ring->head + lo) % ring->cap;
+  int total = hi > lo ? hi - lo : 0;
+
+  n[0] = total < ring->cap - first ? total : ring->cap - first;
+  n[1] = total - n[0];
+  part[0] = ring->base + (size_t)first * ring->size;
+  part[1] = ring->base;
+  return total;
+}
+
+/**  @brief Reverse a run of full resolution samples in place.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param s first sample.
+ *   @param n number of samples.
+ *   @return void
+ */
+static void GhHistoryReverse(histsample_s *s, int n)
+{
+  histsample_s t;
+  int i;
+
+  for (i = 0; i < n / 2; i++)
+  {
+    t = s[i];
+    s[i] = s[n - 1 - i];
+    s[n - 1 - i] = t;
+  }
+}
+
+/**  @brief Change how many full resolution samples are kept, keeping the
+ * newest ones.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param count samples to keep, 1 to HISTSAMPLESMAX.
+ *   @return void
+ */
+void GhHistorySetup(int count)
+{
+  histring_s *ring = &rings[0];
+
+  count = count < 1 ? 1 : count > HISTSAMPLESMAX ? HISTSAMPLESMAX : count;
+  if (count == ring->cap)
+  {
+    return;
+  }
+  // Rotate the ring so the oldest sample is first, then drop the excess
+  GhHistoryReverse(samples, ring->head);
+  GhHistoryReverse(samples + ring->head, ring->cap - ring->head);
+  GhHistoryReverse(samples, ring->cap);
+  if (ring->count > count)
+  {
+    memmove(samples, samples + ring->count - count,
+            count * sizeof(histsample_s));
+    ring->count = count;
+  }
+  ring->head = 0;
+  ring->cap = count;
+}
+
+/**  @brief Fold a sample into the newest bucket of a tier, starting a new
+ * bucket when the sample is past its end.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ring tier to fold into.
+ *   @param span seconds per bucket.
+ *   @param rdata sensor readings.
+ *   @param ctrl heater and humidifier states.
+ *   @return void
+ */
+static void GhHistoryFold(histring_s *ring, int span, reading_s rdata,
+                          control_s ctrl)
+{
+  double v[SENSORS];
+  time_t start = rdata.rtime - rdata.rtime % span;
+  histbucket_s *b = NULL;
+  int i;
+
+  v[TEMPERATURE] = rdata.temperature;
+  v[HUMIDITY] = rdata.humidity;
+  v[PRESSURE] = rdata.pressure;
+  if (ring->count > 0)
+  {
+    b = (histbucket_s *)GhHistoryEntry(ring, ring->count - 1);
+  }
+  // A clock stepped back keeps adding to the newest bucket
+  if (b == NULL || start > b->start)
+  {
+    b = (histbucket_s *)GhHistoryPush(ring);
+    memset(b, 0, sizeof(*b));
+    b->start = start;
+  }
+  b->count++;
+  b->heater += ctrl.heater != 0;
+  b->humidifier += ctrl.humidifier != 0;
+  for (i = 0; i < SENSORS; i++)
+  {
+    if (v[i] != v[i])
+    {
+      continue;
+    }
+    if (b->valid[i] == 0 || v[i] < b->min[i])
+    {
+      b->min[i] = v[i];
+    }
+    if (b->valid[i] == 0 || v[i] > b->max[i])
+    {
+      b->max[i] = v[i];
+    }
+    b->valid[i]++;
+    b->sum[i] += v[i];
+  }
+}
+
+/**  @brief Record one controller cycle.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rdata sensor readings.
+ *   @param ctrl heater and humidifier states.
+ *   @return void
+ */
+void GhHistoryAdd(reading_s rdata, control_s ctrl)
+{
+  histsample_s *s = (histsample_s *)GhHistoryPush(&rings[0]);
+  int t;
+
+  s->reading = rdata;
+  s->ctrl = ctrl;
+  added++;
+  for (t = 0; t < HISTTIERS; t++)
+  {
+    GhHistoryFold(&rings[1 + t], spans[t], rdata, ctrl);
+  }
+}
+
+/**  @brief Full resolution samples in a time window.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param from window start.
+ *   @param to window end, exclusive.
+ *   @param part receives the start of each contiguous run, oldest first.
+ *   @param n receives the length of each run.
+ *   @return number of samples in the window.
+ */
+int GhHistorySamples(time_t from, time_t to, const histsample_s *part[2],
+                     int n[2])
+{
+  const char *p[2];
+  int total = GhHistorySlice(&rings[0], from, to, p, n);
+
+  part[0] = (const histsample_s *)p[0];
+  part[1] = (const histsample_s *)p[1];
+  return total;
+}
+
+/**  @brief Full resolution samples added after a cursor, whatever their
+ * times say, so a clock step cannot hide them from the reader.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param seq cursor, the number of samples already read; moved past the
+ * samples returned.
+ *   @param part receives the start of each contiguous run, oldest first.
+ *   @param n receives the length of each run.
+ *   @param missed receives how many samples left the ring unread.
+ *   @return number of samples returned.
+ */
+int GhHistorySince(uint64_t *seq, const histsample_s *part[2], int n[2],
+                   int *missed)
+{
+  const histring_s *ring = &rings[0];
+  uint64_t oldest = added - (uint64_t)ring->count;
+  uint64_t from = *seq > added ? added : *seq;
+  int first, total;
+
+  *missed = from < oldest ? (int)(oldest - from) : 0;
+  from = from < oldest ? oldest : from;
+  total = (int)(added - from);
+  first = (ring->head + ring->count - total) % ring->cap;
+  n[0] = total < ring->cap - first ? total : ring->cap - first;
+  n[1] = total - n[0];
+  part[0] = samples + first;
+  part[1] = samples;
+  *seq = added;
+  return total;
+}
+
+/**  @brief Buckets of a tier starting in a time window. The newest bucket
+ * is still filling.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param tier HISTMINUTE or HISTHOUR.
+ *   @param from window start.
+ *   @param to window end, exclusive.
+ *   @param part receives the start of each contiguous run, oldest first.
+ *   @param n receives the length of each run.
+ *   @return number of buckets in the window.
+ */
+int GhHistoryBuckets(histtier_e tier, time_t from, time_t to,
+                     const histbucket_s *part[2], int n[2])
+{
+  const char *p[2];
+  int total = GhHistorySlice(&rings[1 + tier], from, to, p, n);
+
+  part[0] = (const histbucket_s *)p[0];
+  part[1] = (const histbucket_s *)p[1];
+  return total;
+}
+
+/**  @brief Summarise a time window from the finest tier reaching back to its
+ * start. Windows older than every tier use what the hour tier holds.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param from window start.
+ *   @param to window end, exclusive.
+ *   @return means, extremes and duty cycles over the window.
+ */
+histsummary_s GhHistorySummary(time_t from, time_t to)
+{
+  histsummary_s sum = {0};
+  const histsample_s *sp[2];
+  const histbucket_s *bp[2];
+  int32_t valid[SENSORS] = {0};
+  int64_t heater = 0, humidifier = 0;
+  int n[2], t, i, j, k;
+
+  sum.from = to;
+  if (rings[0].count > 0 && *(time_t *)GhHistoryEntry(&rings[0], 0) <= from)
+  {
+    GhHistorySamples(from, to, sp, n);
+    for (j = 0; j < 2; j++)
+    {
+      for (i = 0; i < n[j]; i++)
+      {
+        const histsample_s *s = &sp[j][i];
+        double v[SENSORS] = {s->reading.temperature, s->reading.humidity,
+                             s->reading.pressure};
+        if (sum.count++ == 0)
+        {
+          sum.from = s->reading.rtime;
+        }
+        heater += s->ctrl.heater != 0;
+        humidifier += s->ctrl.humidifier != 0;
+        for (k = 0; k < SENSORS; k++)
+        {
+          if (v[k] != v[k])
+          {
+            continue;
+          }
+          if (valid[k] == 0 || v[k] < sum.min[k])
+          {
+            sum.min[k] = v[k];
+          }
+          if (valid[k] == 0 || v[k] > sum.max[k])
+          {
+            sum.max[k] = v[k];
+          }
+          valid[k]++;
+          sum.mean[k] += v[k];
+        }
+      }
+    }
+  }
+  else
+  {
+    t = rings[1 + HISTMINUTE].count > 0 &&
+                *(time_t *)GhHistoryEntry(&rings[1 + HISTMINUTE], 0) <= from
+            ? HISTMINUTE
+            : HISTHOUR;
+    // Include the bucket the window starts in
+    GhHistoryBuckets(t, from - spans[t] + 1, to, bp, n);
+    for (j = 0; j < 2; j++)
+    {
+      for (i = 0; i < n[j]; i++)
+      {
+        const histbucket_s *b = &bp[j][i];
+        if (sum.count == 0)
+        {
+          sum.from = b->start;
+        }
+        sum.count += b->count;
+        heater += b->heater;
+        humidifier += b->humidifier;
+        for (k = 0; k < SENSORS; k++)
+        {
+          if (b->valid[k] == 0)
+          {
+            continue;
+          }
+          if (valid[k] == 0 || b->min[k] < sum.min[k])
+          {
+            sum.min[k] = b->min[k];
+          }
+          if (valid[k] == 0 || b->max[k] > sum.max[k])
+          {
+            sum.max[k] = b->max[k];
+          }
+          valid[k] += b->valid[k];
+          sum.mean[k] += b->sum[k];
+        }
+      }
+    }
+  }
+
+  for (k = 0; k < SENSORS; k++)
+  {
+    if (valid[k] == 0)
+    {
+      sum.mean[k] = sum.min[k] = sum.max[k] = NAN;
+    }
+    else
+    {
+      sum.mean[k] /= valid[k];
+    }
+  }
+  sum.heater = sum.count > 0 ? (double)heater / sum.count : 0;
+  sum.humidifier = sum.count > 0 ? (double)humidifier / sum.count : 0;
+  return sum;
+}
@@ -0,0 +1,66 @@
+/**  @brief Reading history constants, structures, function prototypes
+ *   @file ghhistory.h
+ */
+#ifndef GHHISTORY_H
+#define GHHISTORY_H
+#include "ghcontrol.h"
+#include <stdint.h>
+#include <time.h>
+
+#define HISTSAMPLES 1800     // default full resolution samples kept
+#define HISTSAMPLESMAX 7200  // full resolution samples preallocated
+// Each tier holds one bucket more than its span so that a window of the full
+// span still finds its start in the tier while the newest bucket fills
+#define HISTMINUTES 1441     // one minute buckets, a day
+#define HISTHOURS 721        // one hour buckets, thirty days
+
+typedef enum
+{
+  HISTMINUTE,
+  HISTHOUR,
+  HISTTIERS
+} histtier_e;
+
+// Every history entry starts with its time so one search serves all tiers
+typedef struct histsample
+{
+  reading_s reading;
+  control_s ctrl;
+} histsample_s;
+
+typedef struct histbucket
+{
+  time_t start;             // first second of the bucket
+  int32_t count;            // samples folded in
+  int32_t heater;           // samples with the heater on
+  int32_t humidifier;       // samples with the humidifier on
+  int32_t valid[SENSORS];   // samples with a reading, NAN readings are left out
+  double sum[SENSORS];
+  double min[SENSORS];
+  double max[SENSORS];
+} histbucket_s;
+
+typedef struct histsummary
+{
+  time_t from;              // oldest time covered
+  int32_t count;            // samples summarised
+  double mean[SENSORS];     // NAN if no sample had a reading
+  double min[SENSORS];
+  double max[SENSORS];
+  double heater;            // fraction of samples with the heater on
+  double humidifier;        // fraction of samples with the humidifier on
+} histsummary_s;
+
+///@cond INTERNAL
+void GhHistorySetup(int samples);
+void GhHistoryAdd(reading_s rdata, control_s ctrl);
+int GhHistorySamples(time_t from, time_t to, const histsample_s *part[2],
+                     int n[2]);
+int GhHistorySince(uint64_t *seq, const histsample_s *part[2], int n[2],
+                   int *missed);
+int GhHistoryBuckets(histtier_e tier, time_t from, time_t to,
+                     const histbucket_s *part[2], int n[2]);
+histsummary_s GhHistorySummary(time_t from, time_t to);
+///@endcond
+
+#endif
@@ -0,0 +1,838 @@
+/**  @brief Code for the non-blocking loopback metrics HTTP endpoint
+ *   @file ghhttp.c
+ */
+#define _GNU_SOURCE
+#include "ghhttp.h"
+#include "ghhistory.h"
+#include "ghnotify.h"
+#include "ghpool.h"
+#include "ghsched.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+static int listenfd = -1;              // Listening socket handle
+static int epollfd = -1;               // epoll instance for listen and clients
+static httpconn_s conns[HTTPMAXCONN];  // Preallocated client connections
+static httpstats_s stats;              // Request counters
+static httpcache_s cache[HTTPPAGES];   // Rendered bodies, one per page
+static uint64_t pollstart;             // Thread CPU time the wakeup began at
+
+/**  @brief Read a clock in microseconds.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param clk clock to read.
+ *   @return time in microseconds.
+ */
+static uint64_t GhHttpClock(clockid_t clk)
+{
+  struct timespec ts;
+  clock_gettime(clk, &ts);
+  return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**  @brief Append formatted text to a buffer, stopping quietly when full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param buf buffer being filled.
+ *   @param len current length, advanced by the text written.
+ *   @param size capacity of buf.
+ *   @param fmt printf style format.
+ *   @return void
+ */
+static void GhHttpAppend(char *buf, size_t *len, size_t size, const char *fmt,
+                         ...)
+{
+  va_list ap;
+  int n;
+
+  if (*len >= size)
+  {
+    return;
+  }
+  va_start(ap, fmt);
+  n = vsnprintf(buf + *len, size - *len, fmt, ap);
+  va_end(ap);
+  if (n > 0)
+  {
+    *len += n;
+    if (*len > size)
+    {
+      *len = size;
+    }
+  }
+}
+
+/**  @brief Render the snapshot in Prometheus text exposition format.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param buf buffer receiving the text.
+ *   @param size capacity of buf.
+ *   @return length of the text.
+ */
+static size_t GhHttpMetrics(const snapshot_s *snap, char *buf, size_t size)
+{
+  notifystats_s ns = GhNotifyStats();
+  size_t len = 0;
+  int code;
+  uint32_t i;
+
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_temperature_celsius gauge\n"
+               "gh_temperature_celsius %.1lf\n"
+               "# TYPE gh_humidity_percent gauge\n"
+               "gh_humidity_percent %.1lf\n"
+               "# TYPE gh_pressure_millibars gauge\n"
+               "gh_pressure_millibars %.1lf\n"
+               "# TYPE gh_reading_timestamp_seconds gauge\n"
+               "gh_reading_timestamp_seconds %lld\n",
+               snap->reading.temperature, snap->reading.humidity,
+               snap->reading.pressure, (long long)snap->reading.rtime);
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_setpoint_temperature_celsius gauge\n"
+               "gh_setpoint_temperature_celsius %.1lf\n"
+               "# TYPE gh_setpoint_humidity_percent gauge\n"
+               "gh_setpoint_humidity_percent %.1lf\n"
+               "# TYPE gh_heater_on gauge\n"
+               "gh_heater_on %d\n"
+               "# TYPE gh_humidifier_on gauge\n"
+               "gh_humidifier_on %d\n",
+               snap->spts.temperature, snap->spts.humidity, snap->ctrl.heater,
+               snap->ctrl.humidifier);
+  GhHttpAppend(buf, &len, size, "# TYPE gh_alarm_active gauge\n");
+  for (code = NOALARM + 1; code < NALARMS; code++)
+  {
+    int active = 0;
+    for (i = 0; i < snap->nalarms; i++)
+    {
+      active |= snap->alarms[i].code == code;
+    }
+    GhHttpAppend(buf, &len, size, "gh_alarm_active{alarm=\"%s\"} %d\n",
+                 alarmnames[code], active);
+  }
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_alarm_raised_timestamp_seconds gauge\n");
+  for (i = 0; i < snap->nalarms; i++)
+  {
+    GhHttpAppend(buf, &len, size,
+                 "gh_alarm_raised_timestamp_seconds{alarm=\"%s\"} %lld\n",
+                 alarmnames[snap->alarms[i].code],
+                 (long long)snap->alarms[i].atime);
+  }
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_cycles_total counter\n"
+               "gh_cycles_total %llu\n"
+               "# TYPE gh_cycle_seconds gauge\n"
+               "gh_cycle_seconds %.6lf\n"
+               "# TYPE gh_cycle_max_seconds gauge\n"
+               "gh_cycle_max_seconds %.6lf\n"
+               "# TYPE gh_sample_interval_seconds gauge\n"
+               "gh_sample_interval_seconds %.3lf\n"
+               "# TYPE gh_log_errors_total counter\n"
+               "gh_log_errors_total %llu\n"
+               "# TYPE gh_config_errors_total counter\n"
+               "gh_config_errors_total %llu\n",
+               (unsigned long long)snap->cycles, snap->cycleus / 1e6,
+               snap->maxcycleus / 1e6, snap->samplems / 1e3,
+               (unsigned long long)snap->logerrors,
+               (unsigned long long)snap->configerrors);
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_http_requests_total counter\n"
+               "gh_http_requests_total %llu\n"
+               "# TYPE gh_http_errors_total counter\n"
+               "gh_http_errors_total %llu\n"
+               "# TYPE gh_http_evicted_total counter\n"
+               "gh_http_evicted_total %llu\n"
+               "# TYPE gh_http_expired_total counter\n"
+               "gh_http_expired_total %llu\n"
+               "# TYPE gh_http_deferred_total counter\n"
+               "gh_http_deferred_total %llu\n"
+               "# TYPE gh_http_over_budget_total counter\n"
+               "gh_http_over_budget_total %llu\n",
+               (unsigned long long)stats.requests,
+               (unsigned long long)stats.errors,
+               (unsigned long long)stats.evicted,
+               (unsigned long long)stats.expired,
+               (unsigned long long)stats.deferred,
+               (unsigned long long)stats.overbudget);
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_notify_events_total counter\n"
+               "gh_notify_events_total{outcome=\"posted\"} %llu\n"
+               "gh_notify_events_total{outcome=\"coalesced\"} %llu\n"
+               "gh_notify_events_total{outcome=\"dropped\"} %llu\n"
+               "# TYPE gh_notify_notices_total counter\n"
+               "gh_notify_notices_total{outcome=\"delivered\"} %llu\n"
+               "gh_notify_notices_total{outcome=\"unrouted\"} %llu\n"
+               "gh_notify_notices_total{outcome=\"failed\"} %llu\n"
+               "# TYPE gh_notify_retries_total counter\n"
+               "gh_notify_retries_total %llu\n",
+               (unsigned long long)ns.posted, (unsigned long long)ns.coalesced,
+               (unsigned long long)ns.dropped,
+               (unsigned long long)ns.delivered,
+               (unsigned long long)ns.unrouted, (unsigned long long)ns.failed,
+               (unsigned long long)ns.retries);
+  GhHttpAppend(buf, &len, size,
+               "# TYPE gh_memory_budget_bytes gauge\n"
+               "gh_memory_budget_bytes %d\n"
+               "# TYPE gh_memory_pooled_bytes gauge\n"
+               "gh_memory_pooled_bytes %zu\n"
+               "# TYPE gh_pool_blocks gauge\n",
+               POOLBUDGET, GhPoolUsed());
+  for (i = 0; i < (uint32_t)GhPoolCount(); i++)
+  {
+    const pool_s *pool = GhPoolGet(i);
+    GhHttpAppend(buf, &len, size,
+                 "gh_pool_blocks{pool=\"%s\",state=\"capacity\"} %u\n"
+                 "gh_pool_blocks{pool=\"%s\",state=\"inuse\"} %u\n"
+                 "gh_pool_blocks{pool=\"%s\",state=\"highwater\"} %u\n",
+                 pool->name, pool->capacity, pool->name, pool->inuse,
+                 pool->name, pool->highwater);
+  }
+  GhHttpAppend(buf, &len, size, "# TYPE gh_pool_failures_total counter\n");
+  for (i = 0; i < (uint32_t)GhPoolCount(); i++)
+  {
+    const pool_s *pool = GhPoolGet(i);
+    GhHttpAppend(buf, &len, size, "gh_pool_failures_total{pool=\"%s\"} %llu\n",
+                 pool->name, (unsigned long long)pool->failures);
+  }
+  GhHttpAppend(buf, &len, size, "# TYPE gh_task_runs_total counter\n");
+  for (i = 0; i < (uint32_t)GhSchedCount(); i++)
+  {
+    const schedtask_s *t = GhSchedGet(i);
+    GhHttpAppend(buf, &len, size, "gh_task_runs_total{task=\"%s\"} %llu\n",
+                 t->name, (unsigned long long)t->runs);
+  }
+  GhHttpAppend(buf, &len, size, "# TYPE gh_task_skipped_total counter\n");
+  for (i = 0; i < (uint32_t)GhSchedCount(); i++)
+  {
+    const schedtask_s *t = GhSchedGet(i);
+    GhHttpAppend(buf, &len, size, "gh_task_skipped_total{task=\"%s\"} %llu\n",
+                 t->name, (unsigned long long)t->skipped);
+  }
+  GhHttpAppend(buf, &len, size, "# TYPE gh_task_period_seconds gauge\n");
+  for (i = 0; i < (uint32_t)GhSchedCount(); i++)
+  {
+    const schedtask_s *t = GhSchedGet(i);
+    GhHttpAppend(buf, &len, size, "gh_task_period_seconds{task=\"%s\"} %.3lf\n",
+                 t->name, t->period / 1e3);
+  }
+  GhHttpAppend(buf, &len, size, "# TYPE gh_task_max_seconds gauge\n");
+  for (i = 0; i < (uint32_t)GhSchedCount(); i++)
+  {
+    const schedtask_s *t = GhSchedGet(i);
+    GhHttpAppend(buf, &len, size, "gh_task_max_seconds{task=\"%s\"} %.3lf\n",
+                 t->name, t->maxms / 1e3);
+  }
+  return len;
+}
+
+/**  @brief Append a number to JSON text, null if it is NAN.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param buf buffer being filled.
+ *   @param len current length, advanced by the text written.
+ *   @param size capacity of buf.
+ *   @param name member name.
+ *   @param v value.
+ *   @param prec digits after the decimal point.
+ *   @return void
+ */
+static void GhHttpNumber(char *buf, size_t *len, size_t size, const char *name,
+                         double v, int prec)
+{
+  if (v != v)
+  {
+    GhHttpAppend(buf, len, size, "\"%s\":null", name);
+  }
+  else
+  {
+    GhHttpAppend(buf, len, size, "\"%s\":%.*lf", name, prec, v);
+  }
+}
+
+/**  @brief Render the snapshot as a JSON object.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param buf buffer receiving the text.
+ *   @param size capacity of buf.
+ *   @return length of the text.
+ */
+static size_t GhHttpJson(const snapshot_s *snap, char *buf, size_t size)
+{
+  size_t len = 0;
+  uint32_t i;
+
+  GhHttpAppend(buf, &len, size,
+               "{\"unit\":\"%llx\",\"cycles\":%llu,"
+               "\"readings\":{\"time\":%lld,",
+               (unsigned long long)snap->serial,
+               (unsigned long long)snap->cycles,
+               (long long)snap->reading.rtime);
+  GhHttpNumber(buf, &len, size, "temperature", snap->reading.temperature, 1);
+  GhHttpAppend(buf, &len, size, ",");
+  GhHttpNumber(buf, &len, size, "humidity", snap->reading.humidity, 1);
+  GhHttpAppend(buf, &len, size, ",");
+  GhHttpNumber(buf, &len, size, "pressure", snap->reading.pressure, 1);
+  GhHttpAppend(
+      buf, &len, size,
+      "},\"targets\":{\"temperature\":%.1lf,\"humidity\":%.1lf},"
+      "\"controls\":{\"heater\":%d,\"humidifier\":%d},"
+      "\"timing\":{\"cycle_us\":%llu,\"max_cycle_us\":%llu,\"sample_ms\":%u},"
+      "\"errors\":{\"log\":%llu,\"config\":%llu,\"http\":%llu},"
+      "\"alarms\":[",
+      snap->spts.temperature, snap->spts.humidity, snap->ctrl.heater,
+      snap->ctrl.humidifier, (unsigned long long)snap->cycleus,
+      (unsigned long long)snap->maxcycleus, snap->samplems,
+      (unsigned long long)snap->logerrors,
+      (unsigned long long)snap->configerrors,
+      (unsigned long long)stats.errors);
+  for (i = 0; i < snap->nalarms; i++)
+  {
+    GhHttpAppend(buf, &len, size,
+                 "%s{\"code\":%d,\"name\":\"%s\",\"time\":%lld,",
+                 i ? "," : "", snap->alarms[i].code,
+                 alarmnames[snap->alarms[i].code],
+                 (long long)snap->alarms[i].atime);
+    GhHttpNumber(buf, &len, size, "value", snap->alarms[i].value, 1);
+    GhHttpAppend(buf, &len, size, "}");
+  }
+  GhHttpAppend(buf, &len, size, "]}\n");
+  return len;
+}
+
+/**  @brief Render trend summaries of recent windows from the in-memory
+ * history as JSON.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param buf buffer receiving the text.
+ *   @param size capacity of buf.
+ *   @return length of the text.
+ */
+static size_t GhHttpTrend(const snapshot_s *snap, char *buf, size_t size)
+{
+  static const char *wnames[] = {"10m", "1h", "1d", "30d"};
+  static const int wseconds[] = {600, 3600, 86400, 30 * 86400};
+  static const char *snames[SENSORS] = {"temperature", "humidity", "pressure"};
+  time_t now = snap->reading.rtime;
+  histsummary_s sum;
+  size_t len = 0;
+  int w, k;
+
+  GhHttpAppend(buf, &len, size, "{\"time\":%lld,\"windows\":[",
+               (long long)now);
+  for (w = 0; w < 4; w++)
+  {
+    sum = GhHistorySummary(now - wseconds[w], now + 1);
+    GhHttpAppend(buf, &len, size,
+                 "%s{\"window\":\"%s\",\"from\":%lld,\"samples\":%d,",
+                 w ? "," : "", wnames[w], (long long)sum.from, sum.count);
+    for (k = 0; k < SENSORS; k++)
+    {
+      GhHttpAppend(buf, &len, size, "\"%s\":{", snames[k]);
+      GhHttpNumber(buf, &len, size, "mean", sum.mean[k], 2);
+      GhHttpAppend(buf, &len, size, ",");
+      GhHttpNumber(buf, &len, size, "min", sum.min[k], 2);
+      GhHttpAppend(buf, &len, size, ",");
+      GhHttpNumber(buf, &len, size, "max", sum.max[k], 2);
+      GhHttpAppend(buf, &len, size, "},");
+    }
+    GhHttpAppend(buf, &len, size, "\"heater\":%.3lf,\"humidifier\":%.3lf}",
+                 sum.heater, sum.humidifier);
+  }
+  GhHttpAppend(buf, &len, size, "]}\n");
+  return len;
+}
+
+/**  @brief Release a client connection slot.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param conn connection to close.
+ *   @return void
+ */
+static void GhHttpDrop(httpconn_s *conn)
+{
+  if (conn->fd != -1)
+  {
+    epoll_ctl(epollfd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+  }
+  conn->fd = -1;
+  conn->reqlen = conn->resplen = conn->respsent = 0;
+  conn->pending = 0;
+}
+
+/**  @brief Body of a page, rendered again only once the snapshot has
+ * changed or HTTPCACHEMS has passed, so a burst of requests costs one
+ * rendering. A rendering is only started while HTTPREQBUDGETUS of the
+ * wakeup's budget is left.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param page page to return.
+ *   @param snap current controller snapshot.
+ *   @return cached body, len HTTPRESPSZ if it did not fit, NULL if the body
+ * has to be rendered and the budget is spent.
+ */
+static const httpcache_s *GhHttpPage(httppage_e page, const snapshot_s *snap)
+{
+  static size_t (*const render[HTTPPAGES])(const snapshot_s *, char *,
+                                           size_t) = {GhHttpMetrics, GhHttpJson,
+                                                      GhHttpTrend};
+  httpcache_s *c = &cache[page];
+  uint64_t now = GhHttpClock(CLOCK_MONOTONIC);
+
+  if (c->rendered == 0 || c->cycles != snap->cycles ||
+      now - c->rendered >= (uint64_t)HTTPCACHEMS * 1000)
+  {
+    if (GhHttpClock(CLOCK_THREAD_CPUTIME_ID) - pollstart + HTTPREQBUDGETUS >
+        HTTPPOLLBUDGETUS)
+    {
+      return NULL;
+    }
+    c->len = render[page](snap, c->body, sizeof(c->body));
+    c->cycles = snap->cycles;
+    c->rendered = now;
+  }
+  return c;
+}
+
+/**  @brief Build the response for a complete request. A body too large for
+ * the response buffer is answered with an error rather than cut short.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param conn connection holding the request.
+ *   @param snap current controller snapshot.
+ *   @return 1 if the response was built, 0 if its body could not be rendered
+ * within the budget.
+ */
+static int GhHttpRespond(httpconn_s *conn, const snapshot_s *snap)
+{
+  const char *status = "200 OK";
+  const char *ctype = "text/plain; version=0.0.4";
+  const char *body = NULL;
+  const httpcache_s *page = NULL;
+  size_t blen;
+
+  if (strncmp(conn->req, "GET ", 4) != 0)
+  {
+    status = "405 Method Not Allowed";
+    body = "method not allowed\n";
+  }
+  else if (strncmp(conn->req + 4, "/metrics ", 9) == 0)
+  {
+    page = GhHttpPage(HTTPMETRICS, snap);
+  }
+  else if (strncmp(conn->req + 4, "/json ", 6) == 0)
+  {
+    ctype = "application/json";
+    page = GhHttpPage(HTTPJSON, snap);
+  }
+  else if (strncmp(conn->req + 4, "/trend ", 7) == 0)
+  {
+    ctype = "application/json";
+    page = GhHttpPage(HTTPTREND, snap);
+  }
+  else
+  {
+    status = "404 Not Found";
+    body = "not found\n";
+  }
+  if (body == NULL && page == NULL)
+  {
+    return 0;
+  }
+  stats.requests++;
+  if (body == NULL)
+  {
+    body = page->body;
+    blen = page->len;
+  }
+  else
+  {
+    blen = strlen(body);
+    stats.errors++;
+  }
+
+  conn->resplen = snprintf(conn->resp, sizeof(conn->resp),
+                           "HTTP/1.0 %s\r\nContent-Type: %s\r\n"
+                           "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                           status, ctype, blen);
+  if (blen >= HTTPRESPSZ || conn->resplen + blen > sizeof(conn->resp))
+  {
+    body = "response too large\n";
+    blen = strlen(body);
+    stats.errors++;
+    conn->resplen = snprintf(conn->resp, sizeof(conn->resp),
+                             "HTTP/1.0 500 Internal Server Error\r\n"
+                             "Content-Type: text/plain\r\n"
+                             "Content-Length: %zu\r\nConnection: close\r\n\r\n",
+                             blen);
+  }
+  memcpy(conn->resp + conn->resplen, body, blen);
+  conn->resplen += blen;
+  conn->respsent = 0;
+  return 1;
+}
+
+/**  @brief Send as much of a pending response as the socket accepts.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param conn connection with a response to send.
+ *   @return void
+ */
+static void GhHttpSend(httpconn_s *conn)
+{
+  ssize_t n;
+
+  while (conn->respsent < conn->resplen)
+  {
+    n = send(conn->fd, conn->resp + conn->respsent,
+             conn->resplen - conn->respsent, MSG_NOSIGNAL | MSG_DONTWAIT);
+    if (n <= 0)
+    {
+      if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+      {
+        struct epoll_event ev = {0};
+        ev.events = EPOLLOUT;
+        ev.data.u32 = conn - conns;
+        epoll_ctl(epollfd, EPOLL_CTL_MOD, conn->fd, &ev);
+        return;
+      }
+      stats.errors++;
+      break;
+    }
+    conn->respsent += n;
+  }
+  GhHttpDrop(conn);
+}
+
+/**  @brief Answer a complete request, or leave it pending for a later
+ * wakeup when its body cannot be rendered within the budget.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param conn connection holding the request.
+ *   @param snap current controller snapshot.
+ *   @return void
+ */
+static void GhHttpAnswer(httpconn_s *conn, const snapshot_s *snap)
+{
+  uint64_t start = GhHttpClock(CLOCK_THREAD_CPUTIME_ID);
+
+  if (!GhHttpRespond(conn, snap))
+  {
+    stats.deferred += !conn->pending;
+    conn->pending = 1;
+    return;
+  }
+  conn->pending = 0;
+  if (GhHttpClock(CLOCK_THREAD_CPUTIME_ID) - start > HTTPREQBUDGETUS)
+  {
+    // Started within budget but overran it, sending costs less than a retry
+    stats.overbudget++;
+  }
+  GhHttpSend(conn);
+}
+
+/**  @brief Accept every pending client. Without a free slot the oldest
+ * client, the one closest to its deadline, is dropped to make room.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+static void GhHttpAccept(void)
+{
+  struct epoll_event ev = {0};
+  int fd, i, oldest;
+
+  while ((fd = accept4(listenfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) !=
+         -1)
+  {
+    oldest = 0;
+    for (i = 0; i < HTTPMAXCONN && conns[i].fd != -1; i++)
+    {
+      if (conns[i].deadline < conns[oldest].deadline)
+      {
+        oldest = i;
+      }
+    }
+    if (i == HTTPMAXCONN)
+    {
+      stats.evicted++;
+      GhHttpDrop(&conns[oldest]);
+      i = oldest;
+    }
+    conns[i].fd = fd;
+    conns[i].deadline =
+        GhHttpClock(CLOCK_MONOTONIC) + (uint64_t)HTTPIDLEMS * 1000;
+    conns[i].reqlen = conns[i].resplen = conns[i].respsent = 0;
+    conns[i].pending = 0;
+    ev.events = EPOLLIN;
+    ev.data.u32 = i;
+    if (epoll_ctl(epollfd, EPOLL_CTL_ADD, fd, &ev) == -1)
+    {
+      stats.errors++;
+      close(fd);
+      conns[i].fd = -1;
+    }
+  }
+}
+
+/**  @brief Read request bytes and answer once the header is complete.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param conn connection with data to read.
+ *   @param snap current controller snapshot.
+ *   @return void
+ */
+static void GhHttpRead(httpconn_s *conn, const snapshot_s *snap)
+{
+  ssize_t n;
+
+  n = recv(conn->fd, conn->req + conn->reqlen,
+           sizeof(conn->req) - 1 - conn->reqlen, MSG_DONTWAIT);
+  if (n <= 0)
+  {
+    if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+    {
+      return;
+    }
+    GhHttpDrop(conn);
+    return;
+  }
+  conn->reqlen += n;
+  conn->req[conn->reqlen] = '\0';
+  if (strstr(conn->req, "\r\n\r\n") == NULL &&
+      strstr(conn->req, "\n\n") == NULL)
+  {
+    if (conn->reqlen == sizeof(conn->req) - 1)
+    {
+      // Oversized request header
+      stats.errors++;
+      GhHttpDrop(conn);
+    }
+    return;
+  }
+  GhHttpAnswer(conn, snap);
+}
+
+/**  @brief Open the loopback listening socket.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param port TCP port to listen on.
+ *   @return 1 or 0 depending on whether the endpoint is listening.
+ */
+int GhHttpOpen(int port)
+{
+  struct sockaddr_in addr = {0};
+  struct epoll_event ev = {0};
+  int i, on = 1;
+
+  for (i = 0; i < HTTPMAXCONN; i++)
+  {
+    conns[i].fd = -1;
+  }
+  listenfd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (listenfd == -1)
+  {
+    perror("Error (call to 'socket')");
+    return 0;
+  }
+  setsockopt(listenfd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(listenfd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+      listen(listenfd, HTTPMAXCONN) == -1)
+  {
+    perror("Error (call to 'bind')");
+    GhHttpClose();
+    return 0;
+  }
+  epollfd = epoll_create1(EPOLL_CLOEXEC);
+  if (epollfd == -1)
+  {
+    perror("Error (call to 'epoll_create1')");
+    GhHttpClose();
+    return 0;
+  }
+  ev.events = EPOLLIN;
+  ev.data.u32 = HTTPMAXCONN;
+  if (epoll_ctl(epollfd, EPOLL_CTL_ADD, listenfd, &ev) == -1)
+  {
+    perror("Error (call to 'epoll_ctl')");
+    GhHttpClose();
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Wait for and serve endpoint events within the CPU budget. Events
+ * and requests left over when the budget runs out are served on the next
+ * call, which does not wait while requests are pending and answers them
+ * first.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param timeoutms longest time to wait for an event.
+ *   @return number of events handled.
+ */
+int GhHttpPoll(const snapshot_s *snap, int timeoutms)
+{
+  struct epoll_event evs[HTTPMAXEVENTS];
+  int i, n, pending = 0;
+
+  if (epollfd == -1)
+  {
+    return 0;
+  }
+  for (i = 0; i < HTTPMAXCONN; i++)
+  {
+    pending += conns[i].fd != -1 && conns[i].pending;
+  }
+  n = epoll_wait(epollfd, evs, HTTPMAXEVENTS, pending > 0 ? 0 : timeoutms);
+  pollstart = GhHttpClock(CLOCK_THREAD_CPUTIME_ID);
+  for (i = 0; i < HTTPMAXCONN && pending > 0; i++)
+  {
+    if (conns[i].fd != -1 && conns[i].pending)
+    {
+      GhHttpAnswer(&conns[i], snap);
+    }
+  }
+  for (i = 0; i < n; i++)
+  {
+    if (GhHttpClock(CLOCK_THREAD_CPUTIME_ID) - pollstart > HTTPPOLLBUDGETUS)
+    {
+      break;
+    }
+    if (evs[i].data.u32 == HTTPMAXCONN)
+    {
+      GhHttpAccept();
+      continue;
+    }
+    httpconn_s *conn = &conns[evs[i].data.u32];
+    if (conn->fd == -1)
+    {
+      continue;
+    }
+    if (evs[i].events & (EPOLLERR | EPOLLHUP))
+    {
+      GhHttpDrop(conn);
+    }
+    else if (evs[i].events & EPOLLOUT)
+    {
+      GhHttpSend(conn);
+    }
+    else if (evs[i].events & EPOLLIN)
+    {
+      GhHttpRead(conn, snap);
+    }
+  }
+  return i;
+}
+
+/**  @brief Drop the clients whose deadline has passed.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param now monotonic time in microseconds.
+ *   @return microseconds until the next deadline, -1 if no client is open.
+ */
+static int64_t GhHttpExpire(uint64_t now)
+{
+  int64_t next = -1;
+  int i;
+
+  for (i = 0; i < HTTPMAXCONN; i++)
+  {
+    if (conns[i].fd == -1)
+    {
+      continue;
+    }
+    if (conns[i].deadline <= now)
+    {
+      stats.expired++;
+      GhHttpDrop(&conns[i]);
+    }
+    else if (next == -1 || (int64_t)(conns[i].deadline - now) < next)
+    {
+      next = conns[i].deadline - now;
+    }
+  }
+  return next;
+}
+
+/**  @brief Serve the endpoint until a delay has passed, used in place of
+ * GhDelay so requests are answered while the controller waits. Idle clients
+ * are dropped as their deadlines pass.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap current controller snapshot.
+ *   @param milliseconds time to wait.
+ *   @return void
+ */
+void GhHttpServe(const snapshot_s *snap, int milliseconds)
+{
+  uint64_t deadline, now;
+  int64_t remaining, next;
+
+  if (epollfd == -1)
+  {
+    GhDelay(milliseconds);
+    return;
+  }
+  now = GhHttpClock(CLOCK_MONOTONIC);
+  deadline = now + (uint64_t)milliseconds * 1000;
+  while ((remaining = (int64_t)(deadline - now)) > 0)
+  {
+    next = GhHttpExpire(now);
+    if (next != -1 && next < remaining)
+    {
+      remaining = next;
+    }
+    GhHttpPoll(snap, (remaining + 999) / 1000);
+    now = GhHttpClock(CLOCK_MONOTONIC);
+  }
+}
+
+/**  @brief Return the endpoint request counters.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return copy of the counters.
+ */
+httpstats_s GhHttpStats(void) { return stats; }
+
+/**  @brief Close every client and the listening socket.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhHttpClose(void)
+{
+  int i;
+
+  for (i = 0; i < HTTPMAXCONN; i++)
+  {
+    if (conns[i].fd != -1)
+    {
+      GhHttpDrop(&conns[i]);
+    }
+  }
+  if (epollfd != -1)
+  {
+    close(epollfd);
+    epollfd = -1;
+  }
+  if (listenfd != -1)
+  {
+    close(listenfd);
+    listenfd = -1;
+  }
+}
@@ -0,0 +1,69 @@
+/**  @brief Metrics HTTP endpoint constants, structures, function prototypes
+ *   @file ghhttp.h
+ */
+#ifndef GHHTTP_H
+#define GHHTTP_H
+#include "ghcontrol.h"
+#include <stdint.h>
+
+#define GHHTTPPORT 8153
+#define HTTPMAXCONN 16
+#define HTTPREQSZ 1024
+#define HTTPRESPSZ 8192
+#define HTTPREQBUDGETUS 500   // CPU time one request may use, a body is only
+                              // rendered while this much of the wakeup's
+                              // budget is left
+#define HTTPPOLLBUDGETUS 2000 // CPU time one wakeup may spend on requests
+#define HTTPMAXEVENTS 16
+#define HTTPIDLEMS 2000       // time a client has to send its request and read
+                              // the response before it is dropped
+#define HTTPCACHEMS 1000      // longest time a rendered body is served again
+#define HTTPPAGES 3           // metrics, JSON and trend bodies
+
+typedef enum
+{
+  HTTPMETRICS,
+  HTTPJSON,
+  HTTPTREND
+} httppage_e;
+
+typedef struct httpconn
+{
+  int fd;
+  uint64_t deadline; // monotonic microseconds the connection is dropped at
+  size_t reqlen;
+  size_t resplen;
+  size_t respsent;
+  int pending;       // set while a complete request waits for CPU budget
+  char req[HTTPREQSZ];
+  char resp[HTTPRESPSZ];
+} httpconn_s;
+
+// Each body is rendered at most once per snapshot and HTTPCACHEMS
+typedef struct httpcache
+{
+  uint64_t cycles;   // snapshot cycle the body was rendered from
+  uint64_t rendered; // monotonic microseconds of the rendering, 0 if never
+  size_t len;
+  char body[HTTPRESPSZ];
+} httpcache_s;
+
+typedef struct httpstats
+{
+  uint64_t requests;
+  uint64_t errors;
+  uint64_t evicted;  // idle clients dropped to make room for a new one
+  uint64_t expired;  // clients dropped at their deadline
+  uint64_t deferred; // requests put off to a later wakeup for lack of budget
+  uint64_t overbudget;
+} httpstats_s;
+
+///@cond INTERNAL
+int GhHttpOpen(int port);
+int GhHttpPoll(const snapshot_s *snap, int timeoutms);
+void GhHttpServe(const snapshot_s *snap, int milliseconds);
+httpstats_s GhHttpStats(void);
+void GhHttpClose(void);
+///@endcond
+
+#endif
@@ -0,0 +1,51 @@
+/**  @brief Rebuild or query the sparse time index of ghdata.txt logs
+ *   @file ghidx.c
+ */
+#include "ghindex.h"
+#include "ghlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[])
+{
+  int64_t from = INT64_MIN, to = INT64_MAX, start, end;
+  int query = 0, opt, i, n;
+
+  while ((opt = getopt(argc, argv, "s:e:")) != -1)
+  {
+    if ((opt != 's' && opt != 'e') ||
+        !GhLogParseDate(optarg, opt == 's' ? &from : &to))
+    {
+      fprintf(stderr,
+              "usage: %s [logfile...]            rebuild indexes\n"
+              "       %s -s start [-e end] logfile print byte range\n",
+              argv[0], argv[0]);
+      return EXIT_FAILURE;
+    }
+    query = 1;
+  }
+
+  if (query)
+  {
+    const char *fname = optind < argc ? argv[optind] : GHDATAFILE;
+    GhIndexRange(fname, from, to, &start, &end);
+    printf("%lld %lld\n", (long long)start, (long long)end);
+    return end < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+  }
+  if (optind == argc)
+  {
+    argv[argc++] = GHDATAFILE;
+  }
+  for (i = optind; i < argc; i++)
+  {
+    n = GhIndexRebuild(argv[i]);
+    if (n < 0)
+    {
+      perror(argv[i]);
+      return EXIT_FAILURE;
+    }
+    printf("%s: %d entries\n", argv[i], n);
+  }
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,332 @@
+/**  @brief Code for the sparse time index kept beside each data log
+ *   @file ghindex.c
+ */
+#include "ghindex.h"
+#include "ghlog.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static char lastlog[INDEXNAMESZ];     // Log whose index state is cached
+static int64_t lastbucket = INT64_MIN; // Bucket of the newest index entry
+static int64_t lastoffset = -1;        // Log offset of the newest index entry
+
+/**  @brief Build the sidecar index file name for a log.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @param idxname receives the index file name.
+ *   @param size capacity of idxname.
+ *   @return void
+ */
+void GhIndexName(const char *logname, char *idxname, size_t size)
+{
+  snprintf(idxname, size, "%s%s", logname, INDEXSUFFIX);
+}
+
+/**  @brief Bucket number of a log time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ltime log wall clock seconds.
+ *   @return bucket number.
+ */
+static int64_t GhIndexBucket(int64_t ltime)
+{
+  return ltime >= 0 ? ltime / INDEXBUCKET
+                    : (ltime - INDEXBUCKET + 1) / INDEXBUCKET;
+}
+
+/**  @brief Start a new index file holding only the header.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param idxname index file name.
+ *   @return 1 or 0 depending on whether the file was written.
+ */
+static int GhIndexCreate(const char *idxname)
+{
+  indexheader_s hdr = {INDEXMAGIC, INDEXVERSION, INDEXBUCKET};
+  int fd, ok;
+
+  fd = open(idxname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  ok = write(fd, &hdr, sizeof(hdr)) == sizeof(hdr);
+  close(fd);
+  lastbucket = INT64_MIN;
+  lastoffset = -1;
+  return ok;
+}
+
+/**  @brief Load the newest entry of a log's index, starting a new index if the
+ * existing one is missing or has another layout.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @return 1 or 0 depending on whether the index is usable.
+ */
+static int GhIndexLoad(const char *logname)
+{
+  char idxname[INDEXNAMESZ];
+  indexheader_s hdr = {0};
+  indexentry_s ent;
+  struct stat st;
+  int fd;
+
+  snprintf(lastlog, sizeof(lastlog), "%s", logname);
+  GhIndexName(logname, idxname, sizeof(idxname));
+  lastbucket = INT64_MIN;
+  lastoffset = -1;
+  fd = open(idxname, O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+  {
+    return GhIndexCreate(idxname);
+  }
+  if (pread(fd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+      hdr.magic != INDEXMAGIC || hdr.version != INDEXVERSION ||
+      hdr.bucket != INDEXBUCKET)
+  {
+    close(fd);
+    return GhIndexCreate(idxname);
+  }
+  if (fstat(fd, &st) == 0 &&
+      st.st_size >= (off_t)(sizeof(hdr) + sizeof(ent)) &&
+      pread(fd, &ent, sizeof(ent), st.st_size - sizeof(ent)) == sizeof(ent))
+  {
+    lastbucket = GhIndexBucket(ent.ltime);
+    lastoffset = ent.offset;
+  }
+  close(fd);
+  return 1;
+}
+
+/**  @brief Record where a log record was written if it opens a new bucket.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @param ltime log wall clock time of the record.
+ *   @param offset byte offset the record was appended at.
+ *   @return 1 if an entry was added, 0 otherwise.
+ */
+int GhIndexNote(const char *logname, int64_t ltime, int64_t offset)
+{
+  char idxname[INDEXNAMESZ];
+  indexentry_s ent = {ltime, offset};
+  int64_t bucket = GhIndexBucket(ltime);
+  int fd, ok;
+
+  if (strcmp(logname, lastlog) != 0 && !GhIndexLoad(logname))
+  {
+    return 0;
+  }
+  GhIndexName(logname, idxname, sizeof(idxname));
+  if (offset < lastoffset)
+  {
+    // The log was truncated or replaced, the old entries are stale
+    GhIndexCreate(idxname);
+  }
+  if (bucket <= lastbucket)
+  {
+    return 0;
+  }
+  fd = open(idxname, O_WRONLY | O_APPEND | O_CLOEXEC);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  ok = write(fd, &ent, sizeof(ent)) == sizeof(ent);
+  close(fd);
+  if (!ok)
+  {
+    return 0;
+  }
+  lastbucket = bucket;
+  lastoffset = offset;
+  return 1;
+}
+
+/**  @brief Rebuild a log's index from the log contents.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @return number of index entries written, -1 on error.
+ */
+int GhIndexRebuild(const char *logname)
+{
+  char idxname[INDEXNAMESZ], tmpname[INDEXNAMESZ + 4];
+  indexheader_s hdr = {INDEXMAGIC, INDEXVERSION, INDEXBUCKET};
+  indexentry_s ent;
+  logrecord_s rec;
+  int64_t bucket = INT64_MIN;
+  const char *map, *p, *next, *end;
+  struct stat st;
+  FILE *fp;
+  int fd, n = 0;
+
+  fd = open(logname, O_RDONLY);
+  if (fd == -1 || fstat(fd, &st) == -1)
+  {
+    if (fd != -1)
+    {
+      close(fd);
+    }
+    return -1;
+  }
+  map = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0)
+                       : NULL;
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    return -1;
+  }
+  GhIndexName(logname, idxname, sizeof(idxname));
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", idxname);
+  fp = fopen(tmpname, "w");
+  if (fp == NULL)
+  {
+    if (map != NULL)
+    {
+      munmap((void *)map, st.st_size);
+    }
+    return -1;
+  }
+  fwrite(&hdr, sizeof(hdr), 1, fp);
+  end = map + st.st_size;
+  for (p = map; p < end; p = next)
+  {
+    next = GhLogNextLine(p, end);
+    if (!GhLogParseLine(p, next - p, &rec) ||
+        GhIndexBucket(rec.ltime) <= bucket)
+    {
+      continue;
+    }
+    // Point at the newline before the record, where GhLogData started it
+    ent.ltime = rec.ltime;
+    ent.offset = p > map ? p - map - 1 : 0;
+    fwrite(&ent, sizeof(ent), 1, fp);
+    bucket = GhIndexBucket(rec.ltime);
+    n++;
+  }
+  fclose(fp);
+  if (map != NULL)
+  {
+    munmap((void *)map, st.st_size);
+  }
+  if (rename(tmpname, idxname) != 0)
+  {
+    unlink(tmpname);
+    return -1;
+  }
+  if (strcmp(logname, lastlog) == 0)
+  {
+    lastlog[0] = '\0';
+  }
+  return n;
+}
+
+/**  @brief Find the byte range of a log that holds every record in a window.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @param from window start, log wall clock seconds.
+ *   @param to window end (exclusive), log wall clock seconds.
+ *   @param start receives the offset to start reading at.
+ *   @param end receives the offset to stop reading at.
+ *   @return 1 if the index narrowed the range, 0 if the whole log must be read.
+ */
+int GhIndexRange(const char *logname, int64_t from, int64_t to, int64_t *start,
+                 int64_t *end)
+{
+  char idxname[INDEXNAMESZ];
+  const indexheader_s *hdr;
+  const indexentry_s *ent;
+  struct stat lst, st;
+  size_t n, lo, hi, mid;
+  void *map;
+  int fd;
+
+  *start = 0;
+  *end = -1;
+  GhIndexName(logname, idxname, sizeof(idxname));
+  if (stat(logname, &lst) == -1)
+  {
+    return 0;
+  }
+  *end = lst.st_size;
+  fd = open(idxname, O_RDONLY);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  if (fstat(fd, &st) == -1 || st.st_size < (off_t)sizeof(indexheader_s))
+  {
+    close(fd);
+    return 0;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    return 0;
+  }
+  hdr = map;
+  ent = (const indexentry_s *)(hdr + 1);
+  n = (st.st_size - sizeof(indexheader_s)) / sizeof(indexentry_s);
+  if (hdr->magic != INDEXMAGIC || hdr->version != INDEXVERSION || n == 0 ||
+      ent[n - 1].offset > lst.st_size)
+  {
+    munmap(map, st.st_size);
+    return 0;
+  }
+
+  // Last entry at or before from
+  for (lo = 0, hi = n; lo < hi;)
+  {
+    mid = (lo + hi) / 2;
+    if (ent[mid].ltime <= from)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  *start = lo > 0 ? ent[lo - 1].offset : 0;
+
+  // First entry at or after to
+  for (lo = 0, hi = n; lo < hi;)
+  {
+    mid = (lo + hi) / 2;
+    if (ent[mid].ltime < to)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  if (lo < n)
+  {
+    *end = ent[lo].offset;
+  }
+  munmap(map, st.st_size);
+  return 1;
+}
+
+/**  @brief Forget the cached index state, used after a log is rotated.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhIndexReset(void)
+{
+  lastlog[0] = '\0';
+  lastbucket = INT64_MIN;
+  lastoffset = -1;
+}
@@ -0,0 +1,38 @@
+/**  @brief Sparse time index sidecar constants, structures, function prototypes
+ *   @file ghindex.h
+ */
+#ifndef GHINDEX_H
+#define GHINDEX_H
+#include <stddef.h>
+#include <stdint.h>
+
+#define INDEXSUFFIX ".idx"
+#define INDEXMAGIC 0x58494847 // "GHIX" little endian
+#define INDEXVERSION 1
+#define INDEXBUCKET 3600 // seconds of log covered by one index entry
+#define INDEXNAMESZ 256
+
+typedef struct indexheader
+{
+  uint32_t magic;
+  uint32_t version;
+  int64_t bucket;
+} indexheader_s;
+
+// First record of each time bucket, ltime in log wall clock seconds
+typedef struct indexentry
+{
+  int64_t ltime;
+  int64_t offset;
+} indexentry_s;
+
+///@cond INTERNAL
+void GhIndexName(const char *logname, char *idxname, size_t size);
+int GhIndexNote(const char *logname, int64_t ltime, int64_t offset);
+int GhIndexRebuild(const char *logname);
+int GhIndexRange(const char *logname, int64_t from, int64_t to, int64_t *start,
+                 int64_t *end);
+void GhIndexReset(void);
+///@endcond
+
+#endif
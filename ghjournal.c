@@ -0,0 +1,223 @@
+/**  @brief Code for the alarm raise and clear journal, an in-memory ring
+ * backed by an append only file
+ *   @file ghjournal.c
+ */
+#include "ghjournal.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static alarmevent_s ring[JOURNALRING]; // Most recent events, oldest at rhead
+static int rhead = 0, rcount = 0;
+static int rcomplete = 1;   // Set while the ring holds every journal event
+static int journalfd = -1;  // Journal file handle
+
+/**  @brief Add an event to the ring, replacing the oldest when full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param ev event to add.
+ *   @return void
+ */
+static void GhJournalPush(const alarmevent_s *ev)
+{
+  if (rcount < JOURNALRING)
+  {
+    ring[(rhead + rcount++) % JOURNALRING] = *ev;
+    return;
+  }
+  ring[rhead] = *ev;
+  rhead = (rhead + 1) % JOURNALRING;
+  rcomplete = 0;
+}
+
+/**  @brief Open the journal file and load its newest events into the ring.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname journal file name.
+ *   @return 1 or 0 depending on whether the journal file is in use.
+ */
+int GhJournalOpen(const char *fname)
+{
+  journalheader_s hdr = {JOURNALMAGIC, JOURNALVERSION};
+  alarmevent_s ev;
+  struct stat st;
+  off_t n, i;
+
+  rhead = rcount = 0;
+  rcomplete = 1;
+  journalfd = open(fname, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (journalfd == -1 || fstat(journalfd, &st) == -1)
+  {
+    perror("Error (call to 'open')");
+    GhJournalClose();
+    return 0;
+  }
+  if (st.st_size == 0)
+  {
+    if (write(journalfd, &hdr, sizeof(hdr)) != sizeof(hdr))
+    {
+      GhJournalClose();
+      return 0;
+    }
+    return 1;
+  }
+  if (pread(journalfd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+      hdr.magic != JOURNALMAGIC || hdr.version != JOURNALVERSION)
+  {
+    fprintf(stderr, "%s: not an alarm journal, journaling to memory only\n",
+            fname);
+    GhJournalClose();
+    return 0;
+  }
+
+  // Drop a partially written last event
+  n = (st.st_size - sizeof(hdr)) / sizeof(alarmevent_s);
+  if (sizeof(hdr) + n * sizeof(alarmevent_s) != st.st_size)
+  {
+    ftruncate(journalfd, sizeof(hdr) + n * sizeof(alarmevent_s));
+  }
+  for (i = n > JOURNALRING ? n - JOURNALRING : 0; i < n; i++)
+  {
+    if (pread(journalfd, &ev, sizeof(ev), sizeof(hdr) + i * sizeof(ev)) ==
+        sizeof(ev))
+    {
+      GhJournalPush(&ev);
+    }
+  }
+  rcomplete = n <= JOURNALRING;
+  return 1;
+}
+
+/**  @brief Open an existing journal read only for queries from another
+ * process. Every query is answered from the file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname journal file name.
+ *   @return 1 or 0 depending on whether the file is a journal.
+ */
+int GhJournalAttach(const char *fname)
+{
+  journalheader_s hdr;
+
+  rhead = rcount = 0;
+  rcomplete = 0;
+  journalfd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (journalfd == -1)
+  {
+    return 0;
+  }
+  if (pread(journalfd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+      hdr.magic != JOURNALMAGIC || hdr.version != JOURNALVERSION)
+  {
+    GhJournalClose();
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Record an alarm being raised or cleared.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param code alarm code.
+ *   @param type ALARMRAISE or ALARMCLEAR.
+ *   @param etime time of the event.
+ *   @param value reading that caused the event.
+ *   @return void
+ */
+void GhJournalRecord(int code, alarmevent_e type, time_t etime, double value)
+{
+  alarmevent_s ev = {0};
+
+  ev.etime = etime;
+  ev.code = code;
+  ev.type = type;
+  ev.value = value;
+  GhJournalPush(&ev);
+  if (journalfd != -1 && write(journalfd, &ev, sizeof(ev)) != sizeof(ev))
+  {
+    perror("Error (call to 'write')");
+  }
+}
+
+/**  @brief Copy the events in a time window, oldest first. Windows covered by
+ * the ring are answered from memory, older ones from the journal file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param from window start.
+ *   @param to window end, exclusive.
+ *   @param skip events at the start of the window to pass over, for paging.
+ *   @param events array receiving the events.
+ *   @param max number of elements in events.
+ *   @return number of events copied, -1 if the journal cannot be read.
+ */
+int GhJournalQuery(time_t from, time_t to, int skip, alarmevent_s *events,
+                   int max)
+{
+  const alarmevent_s *fev;
+  struct stat st;
+  size_t lo, hi, mid, nev;
+  void *map;
+  int i, n = 0;
+
+  // An oldest event in the same second as from may have evicted earlier ones
+  if (rcomplete || (rcount > 0 && ring[rhead].etime < from))
+  {
+    for (i = 0; i < rcount && n < max; i++)
+    {
+      const alarmevent_s *ev = &ring[(rhead + i) % JOURNALRING];
+      if (ev->etime >= from && ev->etime < to && skip-- <= 0)
+      {
+        events[n++] = *ev;
+      }
+    }
+    return n;
+  }
+
+  if (journalfd == -1 || fstat(journalfd, &st) == -1 ||
+      st.st_size <= (off_t)sizeof(journalheader_s))
+  {
+    return journalfd == -1 ? -1 : 0;
+  }
+  nev = (st.st_size - sizeof(journalheader_s)) / sizeof(alarmevent_s);
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, journalfd, 0);
+  if (map == MAP_FAILED)
+  {
+    return -1;
+  }
+  fev = (const alarmevent_s *)((const char *)map + sizeof(journalheader_s));
+  for (lo = 0, hi = nev; lo < hi;)
+  {
+    mid = (lo + hi) / 2;
+    if (fev[mid].etime < from)
+    {
+      lo = mid + 1;
+    }
+    else
+    {
+      hi = mid;
+    }
+  }
+  for (lo += skip; lo < nev && fev[lo].etime < to && n < max; lo++)
+  {
+    events[n++] = fev[lo];
+  }
+  munmap(map, st.st_size);
+  return n;
+}
+
+/**  @brief Close the journal file. The ring stays readable.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhJournalClose(void)
+{
+  if (journalfd != -1)
+  {
+    close(journalfd);
+    journalfd = -1;
+  }
+}
@@ -0,0 +1,43 @@
+/**  @brief Alarm event journal constants, structures, function prototypes
+ *   @file ghjournal.h
+ */
+#ifndef GHJOURNAL_H
+#define GHJOURNAL_H
+#include <stdint.h>
+#include <time.h>
+
+#define GHJOURNALFILE "ghalarms.jnl"
+#define JOURNALMAGIC 0x4e4a4847 // "GHJN" little endian
+#define JOURNALVERSION 1
+#define JOURNALRING 256
+
+typedef enum
+{
+  ALARMRAISE,
+  ALARMCLEAR
+} alarmevent_e;
+
+typedef struct journalheader
+{
+  uint32_t magic;
+  uint32_t version;
+} journalheader_s;
+
+typedef struct alarmevent
+{
+  int64_t etime;
+  int32_t code;
+  int32_t type;
+  double value;
+} alarmevent_s;
+
+///@cond INTERNAL
+int GhJournalOpen(const char *fname);
+int GhJournalAttach(const char *fname);
+void GhJournalRecord(int code, alarmevent_e type, time_t etime, double value);
+int GhJournalQuery(time_t from, time_t to, int skip, alarmevent_s *events,
+                   int max);
+void GhJournalClose(void);
+///@endcond
+
+#endif
@@ -0,0 +1,414 @@
+/**  @brief Code for formatting and parsing ghdata.txt records without stdio
+ * or mktime
+ *   @file ghlog.c
+ */
+#include "ghlog.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/**  @brief Count seconds from 1970-01-01 to a calendar date and time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param year four digit year.
+ *   @param month month 1 to 12.
+ *   @param day day of the month 1 to 31.
+ *   @param hour hour 0 to 23.
+ *   @param min minute 0 to 59.
+ *   @param sec second 0 to 60.
+ *   @return seconds since the epoch of the same calendar.
+ */
+int64_t GhLogCivil(int year, int month, int day, int hour, int min, int sec)
+{
+  int64_t era, yoe, doy, doe;
+
+  // Days from civil, shifting the year to start in March
+  year -= month <= 2;
+  era = (year >= 0 ? year : year - 399) / 400;
+  yoe = year - era * 400;
+  doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+  doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return (era * 146097 + doe - 719468) * 86400 + hour * 3600 + min * 60 + sec;
+}
+
+/**  @brief Convert a time to the local wall clock seconds used in the log.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param t time to convert.
+ *   @return local wall clock seconds.
+ */
+int64_t GhLogLocal(time_t t)
+{
+  struct tm tm;
+  localtime_r(&t, &tm);
+  return GhLogCivil(tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour,
+                    tm.tm_min, tm.tm_sec);
+}
+
+/**  @brief Parse a "YYYY-MM-DD[ HH:MM:SS]" date to log wall clock seconds.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param s date text.
+ *   @param ltime receives local wall clock seconds.
+ *   @return 1 if the date was understood.
+ */
+int GhLogParseDate(const char *s, int64_t *ltime)
+{
+  int y, mo, d, h = 0, mi = 0, se = 0;
+  if (sscanf(s, "%d-%d-%d %d:%d:%d", &y, &mo, &d, &h, &mi, &se) < 3)
+  {
+    return 0;
+  }
+  *ltime = GhLogCivil(y, mo, d, h, mi, se);
+  return 1;
+}
+
+/**  @brief Parse a two digit field that may be padded with a space.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p points to the two characters.
+ *   @return the value or -1 if the characters are not digits.
+ */
+static int GhLogTwoDigits(const char *p)
+{
+  int tens = p[0] == ' ' ? 0 : p[0] - '0';
+  int ones = p[1] - '0';
+  if (tens < 0 || tens > 9 || ones < 0 || ones > 9)
+  {
+    return -1;
+  }
+  return tens * 10 + ones;
+}
+
+/**  @brief Parse the 24 character timestamp GhLogData writes, a ctime string
+ * with commas in place of the field separators.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p points to the timestamp, for example "Mon,Apr,19,13:22:19,2021".
+ *   @param ltime receives local wall clock seconds.
+ *   @return 1 if the timestamp is well formed, 0 otherwise.
+ */
+int GhLogParseTime(const char *p, int64_t *ltime)
+{
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  int month, day, hour, min, sec, year, i;
+
+  for (month = 0; month < 12; month++)
+  {
+    if (memcmp(p + 4, months + month * 3, 3) == 0)
+    {
+      break;
+    }
+  }
+  day = GhLogTwoDigits(p + 8);
+  hour = GhLogTwoDigits(p + 11);
+  min = GhLogTwoDigits(p + 14);
+  sec = GhLogTwoDigits(p + 17);
+  if (month == 12 || day < 1 || hour < 0 || min < 0 || sec < 0)
+  {
+    return 0;
+  }
+  for (year = 0, i = 20; i < LOGTIMESZ; i++)
+  {
+    if (p[i] < '0' || p[i] > '9')
+    {
+      return 0;
+    }
+    year = year * 10 + p[i] - '0';
+  }
+  *ltime = GhLogCivil(year, month + 1, day, hour, min, sec);
+  return 1;
+}
+
+/**  @brief Parse one "%5.1lf" style number as fixed point tenths.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p points to the number, leading spaces allowed.
+ *   @param end end of the line.
+ *   @param value receives the number in tenths, LOGMISSING for "nan".
+ *   @return pointer just past the number, NULL if malformed.
+ */
+static const char *GhLogParseTenths(const char *p, const char *end,
+                                    int32_t *value)
+{
+  int32_t v = 0;
+  int neg = 0, digits = 0;
+
+  while (p < end && *p == ' ')
+  {
+    p++;
+  }
+  if (end - p >= 3 && memcmp(p, "nan", 3) == 0)
+  {
+    *value = LOGMISSING;
+    return p + 3;
+  }
+  if (p < end && *p == '-')
+  {
+    neg = 1;
+    p++;
+  }
+  while (p < end && (unsigned)(*p - '0') < 10)
+  {
+    v = v * 10 + (*p++ - '0');
+    digits++;
+  }
+  v *= 10;
+  if (p < end && *p == '.')
+  {
+    p++;
+    if (p < end && (unsigned)(*p - '0') < 10)
+    {
+      v += *p++ - '0';
+    }
+    while (p < end && (unsigned)(*p - '0') < 10)
+    {
+      p++;
+    }
+  }
+  if (digits == 0)
+  {
+    return NULL;
+  }
+  *value = neg ? -v : v;
+  return p;
+}
+
+/**  @brief Parse the hexadecimal unit serial that follows the readings.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p points to the serial.
+ *   @param end end of the line.
+ *   @return the serial, 0 if the field is missing or malformed.
+ */
+static uint64_t GhLogParseUnit(const char *p, const char *end)
+{
+  uint64_t v = 0;
+  int digits = 0, d;
+
+  for (; p < end && digits < LOGUNITSZ; p++, digits++)
+  {
+    if ((unsigned)(*p - '0') < 10)
+    {
+      d = *p - '0';
+    }
+    else if ((unsigned)((*p | 0x20) - 'a') < 6)
+    {
+      d = (*p | 0x20) - 'a' + 10;
+    }
+    else
+    {
+      break;
+    }
+    v = v << 4 | d;
+  }
+  return digits > 0 ? v : 0;
+}
+
+/**  @brief Parse one log line. The unit serial after pressure is optional,
+ * records written before units were tagged have none.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param line start of the line, without the newline.
+ *   @param len length of the line.
+ *   @param rec receives the time, readings and unit serial.
+ *   @return 1 if the line is a record, 0 otherwise.
+ */
+int GhLogParseLine(const char *line, size_t len, logrecord_s *rec)
+{
+  const char *p = line + LOGTIMESZ;
+  const char *end = line + len;
+  int i;
+
+  if (len < LOGTIMESZ + 2 * LOGFIELDS || !GhLogParseTime(line, &rec->ltime))
+  {
+    return 0;
+  }
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    if (p >= end || *p != ',')
+    {
+      return 0;
+    }
+    p = GhLogParseTenths(p + 1, end, &rec->value[i]);
+    if (p == NULL)
+    {
+      return 0;
+    }
+  }
+  rec->unit = p < end && *p == ',' ? GhLogParseUnit(p + 1, end) : 0;
+  return 1;
+}
+
+/**  @brief Find the start of the next line. memchr is vectorized by the C
+ * library, so long runs are skipped many bytes at a time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p current position.
+ *   @param end end of the buffer.
+ *   @return position after the next newline, or end.
+ */
+const char *GhLogNextLine(const char *p, const char *end)
+{
+  const char *nl = memchr(p, '\n', end - p);
+  return nl == NULL ? end : nl + 1;
+}
+
+/**  @brief Write a number as two decimal digits.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p destination.
+ *   @param v number 0 to 99.
+ *   @return void
+ */
+static void GhLogPut2(char *p, int v)
+{
+  p[0] = '0' + v / 10;
+  p[1] = '0' + v % 10;
+}
+
+/**  @brief Return a ctime style stamp for a time, re-rendering the whole stamp
+ * only when the minute changes.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param stamp cache owned by the caller, zero initialised before first use.
+ *   @param t time to format.
+ *   @return the 24 character stamp, without a newline.
+ */
+const char *GhLogStamp(logstamp_s *stamp, time_t t)
+{
+  static const char days[] = "SunMonTueWedThuFriSat";
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  struct tm tm;
+
+  if (stamp->text[0] != '\0' && t >= stamp->minute && t < stamp->minute + 60)
+  {
+    GhLogPut2(stamp->text + 17, (int)(t - stamp->minute));
+    return stamp->text;
+  }
+  localtime_r(&t, &tm);
+  memcpy(stamp->text, days + 3 * tm.tm_wday, 3);
+  stamp->text[3] = ' ';
+  memcpy(stamp->text + 4, months + 3 * tm.tm_mon, 3);
+  stamp->text[7] = ' ';
+  stamp->text[8] = tm.tm_mday < 10 ? ' ' : '0' + tm.tm_mday / 10;
+  stamp->text[9] = '0' + tm.tm_mday % 10;
+  stamp->text[10] = ' ';
+  GhLogPut2(stamp->text + 11, tm.tm_hour);
+  stamp->text[13] = ':';
+  GhLogPut2(stamp->text + 14, tm.tm_min);
+  stamp->text[16] = ':';
+  GhLogPut2(stamp->text + 17, tm.tm_sec);
+  stamp->text[19] = ' ';
+  GhLogPut2(stamp->text + 20, (tm.tm_year + 1900) / 100 % 100);
+  GhLogPut2(stamp->text + 22, (tm.tm_year + 1900) % 100);
+  stamp->text[LOGTIMESZ] = '\0';
+  stamp->minute = t - tm.tm_sec;
+  return stamp->text;
+}
+
+/**  @brief Write a number the way "%*.1lf" does, right aligned in a field.
+ * The value times ten is formed exactly as the sum of v * 8 and v * 2 so it
+ * rounds to tenths the same way printf does, halfway cases to even.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param p destination.
+ *   @param v number to write.
+ *   @param width minimum field width.
+ *   @return pointer just past the field.
+ */
+static char *GhLogPutTenths(char *p, double v, int width)
+{
+  char digits[12];
+  double a, b, s, bb, e, frac;
+  int64_t t;
+  int n = 0, neg;
+
+  if (v != v)
+  {
+    for (; width > 3; width--)
+    {
+      *p++ = ' ';
+    }
+    memcpy(p, "nan", 3);
+    return p + 3;
+  }
+  neg = signbit(v);
+  a = fabs(v) * 8.0;
+  b = fabs(v) * 2.0;
+  s = a + b;
+  bb = s - a;
+  e = (a - (s - bb)) + (b - bb);
+  if (s >= LOGVALUEMAX)
+  {
+    t = LOGVALUEMAX;
+  }
+  else
+  {
+    t = (int64_t)s;
+    frac = s - (double)t;
+    if (frac > 0.5 || (frac == 0.5 && (e > 0 || (e == 0 && (t & 1)))))
+    {
+      t++;
+    }
+  }
+  digits[n++] = '0' + t % 10;
+  digits[n++] = '.';
+  t /= 10;
+  do
+  {
+    digits[n++] = '0' + t % 10;
+    t /= 10;
+  } while (t > 0);
+  if (neg)
+  {
+    digits[n++] = '-';
+  }
+  for (; width > n; width--)
+  {
+    *p++ = ' ';
+  }
+  while (n > 0)
+  {
+    *p++ = digits[--n];
+  }
+  return p;
+}
+
+/**  @brief Format one log record, starting with its newline, into a caller
+ * buffer. Only the stamp cache is touched, so threads with their own cache
+ * can format concurrently.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param buf buffer of at least LOGRECORDSZ characters.
+ *   @param stamp stamp cache owned by the caller.
+ *   @param t time of the record.
+ *   @param value temperature, humidity and pressure.
+ *   @param unit serial of the logging unit.
+ *   @return number of characters written, no terminating nul is added.
+ */
+size_t GhLogFormat(char *buf, logstamp_s *stamp, time_t t,
+                   const double value[LOGFIELDS], uint64_t unit)
+{
+  static const char hex[] = "0123456789abcdef";
+  char *p = buf;
+  int i;
+
+  *p++ = '\n';
+  memcpy(p, GhLogStamp(stamp, t), LOGTIMESZ);
+  p[3] = p[7] = p[10] = p[19] = ',';
+  p += LOGTIMESZ;
+  *p++ = ',';
+  p = GhLogPutTenths(p, value[LOGTEMP], 5);
+  *p++ = ',';
+  p = GhLogPutTenths(p, value[LOGHUMID], 5);
+  *p++ = ',';
+  p = GhLogPutTenths(p, value[LOGPRESS], 6);
+  *p++ = ',';
+  for (i = LOGUNITSZ - 1; i >= 0; i--)
+  {
+    p[i] = hex[unit & 0xf];
+    unit >>= 4;
+  }
+  return p + LOGUNITSZ - buf;
+}
@@ -0,0 +1,51 @@
+/**  @brief Data log record parsing constants, structures, function prototypes
+ *   @file ghlog.h
+ */
+#ifndef GHLOG_H
+#define GHLOG_H
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define GHDATAFILE "ghdata.txt"
+#define LOGFIELDS 3
+#define LOGTIMESZ 24
+#define LOGTEMP 0
+#define LOGHUMID 1
+#define LOGPRESS 2
+#define LOGUNITSZ 16 // hex digits of the unit serial field
+#define LOGRECORDSZ 80 // room for one formatted record with its newline
+#define LOGBATCH 256 // most records appended in one write
+#define LOGVALUEMAX 9999999 // largest magnitude formatted, in tenths
+#define LOGMISSING INT32_MIN // parsed value of a "nan" field
+
+// Times parsed from the log are local wall clock seconds counted from
+// 1970-01-01 00:00:00, the same calendar the ctime stamps are written in.
+typedef struct logrecord
+{
+  int64_t ltime;
+  int32_t value[LOGFIELDS]; // tenths of a unit, LOGMISSING if unknown
+  uint64_t unit;             // serial of the logging unit, 0 if untagged
+} logrecord_s;
+
+// Cached ctime style stamp. Only the seconds are rewritten while the time
+// stays in the same minute. Each thread keeps its own.
+typedef struct logstamp
+{
+  time_t minute;                // first second of the cached minute
+  char text[LOGTIMESZ + 1];     // "Mon Oct 19 13:40:48 2026"
+} logstamp_s;
+
+///@cond INTERNAL
+int64_t GhLogCivil(int year, int month, int day, int hour, int min, int sec);
+int64_t GhLogLocal(time_t t);
+int GhLogParseDate(const char *s, int64_t *ltime);
+int GhLogParseTime(const char *p, int64_t *ltime);
+int GhLogParseLine(const char *line, size_t len, logrecord_s *rec);
+const char *GhLogNextLine(const char *p, const char *end);
+const char *GhLogStamp(logstamp_s *stamp, time_t t);
+size_t GhLogFormat(char *buf, logstamp_s *stamp, time_t t,
+                   const double value[LOGFIELDS], uint64_t unit);
+///@endcond
+
+#endif
@@ -0,0 +1,186 @@
+/**  @brief Merge the data logs of many units into one time ordered series.
+ * Each input is streamed through a small line buffer and a heap holding one
+ * record per input picks the oldest, so memory grows with the number of
+ * inputs, not their size. Inputs may be gzipped rotated segments.
+ *   @file ghmerge.c
+ */
+#include "ghlog.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define MERGELINESZ 128
+#define MERGEOUTBUF (1 << 20)
+
+typedef struct mergeinput
+{
+  gzFile gz;
+  const char *name;
+  logrecord_s rec;
+  char line[MERGELINESZ];
+  size_t len;
+} mergeinput_s;
+
+static mergeinput_s *inputs; // One per file named on the command line
+static int *heap;            // Input numbers ordered by their pending record
+static int nheap = 0;
+
+/**  @brief Order two inputs by pending record time, then by input number so
+ * records with equal times keep a stable order.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param a first input number.
+ *   @param b second input number.
+ *   @return non zero if a comes before b.
+ */
+static int GhMergeBefore(int a, int b)
+{
+  if (inputs[a].rec.ltime != inputs[b].rec.ltime)
+  {
+    return inputs[a].rec.ltime < inputs[b].rec.ltime;
+  }
+  return a < b;
+}
+
+/**  @brief Move the heap entry at i down until both children follow it.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param i heap position.
+ *   @return void
+ */
+static void GhMergeSiftDown(int i)
+{
+  int c, t;
+
+  for (;;)
+  {
+    c = 2 * i + 1;
+    if (c >= nheap)
+    {
+      return;
+    }
+    if (c + 1 < nheap && GhMergeBefore(heap[c + 1], heap[c]))
+    {
+      c++;
+    }
+    if (!GhMergeBefore(heap[c], heap[i]))
+    {
+      return;
+    }
+    t = heap[i];
+    heap[i] = heap[c];
+    heap[c] = t;
+    i = c;
+  }
+}
+
+/**  @brief Read the next record of an input, skipping blank and malformed
+ * lines.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param in input to advance.
+ *   @return 1 if a record was read, 0 at end of input.
+ */
+static int GhMergeNext(mergeinput_s *in)
+{
+  while (gzgets(in->gz, in->line, sizeof(in->line)) != NULL)
+  {
+    in->len = strcspn(in->line, "\r\n");
+    in->line[in->len] = '\0';
+    if (GhLogParseLine(in->line, in->len, &in->rec))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  const char *outname = NULL;
+  unsigned long long written = 0;
+  mergeinput_s *in;
+  FILE *out = stdout;
+  int opt, n, i;
+
+  while ((opt = getopt(argc, argv, "o:")) != -1)
+  {
+    if (opt != 'o')
+    {
+      fprintf(stderr, "usage: %s [-o output] logfile...\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+    outname = optarg;
+  }
+  n = argc - optind;
+  if (n == 0)
+  {
+    fprintf(stderr, "usage: %s [-o output] logfile...\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  inputs = calloc(n, sizeof(mergeinput_s));
+  heap = calloc(n, sizeof(int));
+  if (inputs == NULL || heap == NULL)
+  {
+    fputs("Cannot allocate memory\n", stderr);
+    return EXIT_FAILURE;
+  }
+  if (outname != NULL && (out = fopen(outname, "w")) == NULL)
+  {
+    perror(outname);
+    return EXIT_FAILURE;
+  }
+  setvbuf(out, NULL, _IOFBF, MERGEOUTBUF);
+
+  // gzopen reads plain text logs unchanged, so live logs and compressed
+  // segments can be mixed
+  for (i = 0; i < n; i++)
+  {
+    inputs[i].name = argv[optind + i];
+    inputs[i].gz = gzopen(inputs[i].name, "rb");
+    if (inputs[i].gz == NULL)
+    {
+      perror(inputs[i].name);
+      return EXIT_FAILURE;
+    }
+    gzbuffer(inputs[i].gz, 16384);
+    if (GhMergeNext(&inputs[i]))
+    {
+      heap[nheap++] = i;
+    }
+    else
+    {
+      gzclose(inputs[i].gz);
+    }
+  }
+  for (i = nheap / 2 - 1; i >= 0; i--)
+  {
+    GhMergeSiftDown(i);
+  }
+
+  while (nheap > 0)
+  {
+    in = &inputs[heap[0]];
+    fputc('\n', out);
+    fwrite(in->line, 1, in->len, out);
+    written++;
+    if (!GhMergeNext(in))
+    {
+      gzclose(in->gz);
+      heap[0] = heap[--nheap];
+    }
+    GhMergeSiftDown(0);
+  }
+
+  if (fflush(out) != 0 || (out != stdout && fclose(out) != 0))
+  {
+    perror(outname != NULL ? outname : "stdout");
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%llu records from %d logs\n", written, n);
+  free(heap);
+  free(inputs);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,397 @@
+/**  @brief Code for alarm notifications. Alarm events are queued without
+ * blocking and a dispatcher thread hands them to a command hook and a local
+ * datagram socket. Events for an alarm that already has a notice waiting are
+ * folded into it, each alarm is held to one notice per gap, and failed
+ * deliveries are retried with exponential backoff
+ *   @file ghnotify.c
+ */
+#define _GNU_SOURCE
+#include "ghnotify.h"
+#include <errno.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char **environ;
+
+static pthread_t dispatcher;                // Delivery thread
+static int running = 0;                     // Set while the dispatcher runs
+static pthread_mutex_t nlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t ncond;                // Signals a new notice or stop
+static notice_s queue[NOTIFYQUEUE];         // Waiting notices, unordered
+static int nqueued = 0;
+static uint64_t lastsent[NOTIFYCODES];      // When each alarm last went out
+static uint64_t gapms = NOTIFYGAP * 1000ULL;
+static notifystats_s stats;                 // Delivery counters
+static int sockfd = -1;                     // Unbound datagram socket
+
+/**  @brief Read the monotonic clock in milliseconds.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return milliseconds since an arbitrary start.
+ */
+static uint64_t GhNotifyClock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**  @brief Find the waiting notice for an alarm.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param code alarm code.
+ *   @return the notice, NULL if none is waiting.
+ */
+static notice_s *GhNotifyFind(int code)
+{
+  int i;
+
+  for (i = 0; i < nqueued; i++)
+  {
+    if (queue[i].code == code)
+    {
+      return &queue[i];
+    }
+  }
+  return NULL;
+}
+
+/**  @brief Send a notice to the socket consumer, if one is listening.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param msg notice text.
+ *   @param len length of msg.
+ *   @return 1 if sent, 0 if it failed, -1 if no consumer is listening.
+ */
+static int GhNotifySocket(const char *msg, size_t len)
+{
+  struct sockaddr_un addr = {0};
+
+  if (sockfd == -1)
+  {
+    return -1;
+  }
+  addr.sun_family = AF_UNIX;
+  snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", GHNOTIFYSOCK);
+  if (sendto(sockfd, msg, len, MSG_NOSIGNAL, (struct sockaddr *)&addr,
+             sizeof(addr)) == (ssize_t)len)
+  {
+    return 1;
+  }
+  return errno == ENOENT || errno == ECONNREFUSED ? -1 : 0;
+}
+
+/**  @brief Run the command hook with the notice as its arguments, killing it
+ * if it outlives NOTIFYHOOKMS.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param n notice to pass.
+ *   @return 1 if the hook exited with status 0, 0 if it failed, -1 if there
+ * is no hook.
+ */
+static int GhNotifyHook(const notice_s *n)
+{
+  char value[32], etime[24], events[16];
+  char *argv[] = {GHNOTIFYHOOK, (char *)n->name,
+                  n->type == ALARMRAISE ? "raise" : "clear",
+                  value, etime, events, NULL};
+  uint64_t deadline;
+  pid_t pid, done;
+  int status;
+
+  if (access(GHNOTIFYHOOK, X_OK) != 0)
+  {
+    return -1;
+  }
+  snprintf(value, sizeof(value), "%.1lf", n->value);
+  snprintf(etime, sizeof(etime), "%lld", (long long)n->etime);
+  snprintf(events, sizeof(events), "%u", n->events);
+  if (posix_spawn(&pid, GHNOTIFYHOOK, NULL, NULL, argv, environ) != 0)
+  {
+    return 0;
+  }
+  deadline = GhNotifyClock() + NOTIFYHOOKMS;
+  while ((done = waitpid(pid, &status, WNOHANG)) == 0 &&
+         GhNotifyClock() < deadline)
+  {
+    usleep(10000);
+  }
+  if (done == 0)
+  {
+    kill(pid, SIGKILL);
+    waitpid(pid, &status, 0);
+    return 0;
+  }
+  return done == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**  @brief Hand a notice to every route that does not have it yet.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param n notice to deliver, its sent bits are updated.
+ *   @return 1 if every route present took it, 0 if one failed, -1 if no
+ * route is present.
+ */
+static int GhNotifyDeliver(notice_s *n)
+{
+  char msg[NOTIFYMSGSZ];
+  int len, r, routes = 0, failed = 0;
+
+  len = snprintf(msg, sizeof(msg), "%lld %s %s %.1lf %u\n",
+                 (long long)n->etime, n->name,
+                 n->type == ALARMRAISE ? "raise" : "clear", n->value,
+                 n->events);
+  if (!(n->sent & NOTIFYTOSOCK))
+  {
+    r = GhNotifySocket(msg, len < (int)sizeof(msg) ? len : sizeof(msg) - 1);
+    routes += r != -1;
+    failed += r == 0;
+    n->sent |= r == 1 ? NOTIFYTOSOCK : 0;
+  }
+  if (!(n->sent & NOTIFYTOHOOK))
+  {
+    r = GhNotifyHook(n);
+    routes += r != -1;
+    failed += r == 0;
+    n->sent |= r == 1 ? NOTIFYTOHOOK : 0;
+  }
+  if (failed)
+  {
+    return 0;
+  }
+  return routes > 0 || n->sent ? 1 : -1;
+}
+
+/**  @brief Dispatcher thread. It sends the notice that is due first, then
+ * sleeps until the next one is due or a new one arrives.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return NULL
+ */
+static void *GhNotifyWorker(void *arg)
+{
+  struct timespec ts;
+  notice_s n, *newer;
+  uint64_t now, backoff;
+  int i, first, r;
+
+  pthread_mutex_lock(&nlock);
+  while (running)
+  {
+    if (nqueued == 0)
+    {
+      pthread_cond_wait(&ncond, &nlock);
+      continue;
+    }
+    first = 0;
+    for (i = 1; i < nqueued; i++)
+    {
+      if (queue[i].due < queue[first].due)
+      {
+        first = i;
+      }
+    }
+    now = GhNotifyClock();
+    if (queue[first].due > now)
+    {
+      ts.tv_sec = queue[first].due / 1000;
+      ts.tv_nsec = (queue[first].due % 1000) * 1000000L;
+      pthread_cond_timedwait(&ncond, &nlock, &ts);
+      continue;
+    }
+    n = queue[first];
+    queue[first] = queue[--nqueued];
+    pthread_mutex_unlock(&nlock);
+
+    n.attempts++;
+    r = GhNotifyDeliver(&n);
+    now = GhNotifyClock();
+
+    pthread_mutex_lock(&nlock);
+    if (r == -1)
+    {
+      stats.unrouted++;
+      continue;
+    }
+    if (r == 1)
+    {
+      stats.delivered++;
+      if (n.code >= 0 && n.code < NOTIFYCODES)
+      {
+        lastsent[n.code] = now;
+      }
+      // An event posted during delivery was timed from the previous notice
+      newer = GhNotifyFind(n.code);
+      if (newer != NULL && newer->due < now + gapms)
+      {
+        newer->due = now + gapms;
+      }
+      continue;
+    }
+    newer = GhNotifyFind(n.code);
+    if (newer != NULL)
+    {
+      // A later event for the alarm supersedes the one that failed
+      newer->events += n.events;
+      stats.coalesced += n.events;
+      continue;
+    }
+    if (n.attempts > NOTIFYRETRIES || nqueued == NOTIFYQUEUE)
+    {
+      stats.failed++;
+      continue;
+    }
+    backoff = (uint64_t)NOTIFYBACKOFFMS << (n.attempts - 1);
+    n.due = now + backoff;
+    queue[nqueued++] = n;
+    stats.retries++;
+  }
+  pthread_mutex_unlock(&nlock);
+  return NULL;
+}
+
+/**  @brief Start the dispatcher thread.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param gap seconds between notices for one alarm.
+ *   @return 1 or 0 depending on whether the dispatcher started.
+ */
+int GhNotifyStart(int gap)
+{
+  pthread_condattr_t attr;
+
+  GhNotifyGap(gap);
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&ncond, &attr);
+  pthread_condattr_destroy(&attr);
+  sockfd = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+
+  running = 1;
+  if (pthread_create(&dispatcher, NULL, GhNotifyWorker, NULL) != 0)
+  {
+    running = 0;
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Change the time between notices for one alarm.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param gap seconds, 0 sends every event as soon as the dispatcher can.
+ *   @return void
+ */
+void GhNotifyGap(int gap)
+{
+  pthread_mutex_lock(&nlock);
+  gapms = gap < 0 ? 0 : (uint64_t)gap * 1000;
+  pthread_mutex_unlock(&nlock);
+}
+
+/**  @brief Queue a notice for an alarm event. It never waits on delivery: an
+ * event for an alarm with a notice already waiting replaces that notice's
+ * contents, and an event that finds the queue full is dropped.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param code alarm code.
+ *   @param name alarm name.
+ *   @param type ALARMRAISE or ALARMCLEAR.
+ *   @param etime time of the event.
+ *   @param value reading that caused the event.
+ *   @return void
+ */
+void GhNotifyPost(int code, const char *name, alarmevent_e type, time_t etime,
+                  double value)
+{
+  notice_s *n;
+  uint64_t due;
+
+  if (!running)
+  {
+    return;
+  }
+  pthread_mutex_lock(&nlock);
+  stats.posted++;
+  n = GhNotifyFind(code);
+  if (n != NULL)
+  {
+    stats.coalesced++;
+    n->events++;
+    n->attempts = 0;
+  }
+  else if (nqueued == NOTIFYQUEUE)
+  {
+    stats.dropped++;
+    pthread_mutex_unlock(&nlock);
+    return;
+  }
+  else
+  {
+    n = &queue[nqueued++];
+    memset(n, 0, sizeof(*n));
+    n->events = 1;
+    due = GhNotifyClock();
+    if (code >= 0 && code < NOTIFYCODES && lastsent[code] != 0 &&
+        lastsent[code] + gapms > due)
+    {
+      due = lastsent[code] + gapms;
+    }
+    n->due = due;
+    pthread_cond_signal(&ncond);
+  }
+  n->etime = etime;
+  n->code = code;
+  n->type = type;
+  n->value = value;
+  n->sent = 0;
+  snprintf(n->name, sizeof(n->name), "%s", name);
+  pthread_mutex_unlock(&nlock);
+}
+
+/**  @brief Read the delivery counters.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return a copy of the counters.
+ */
+notifystats_s GhNotifyStats(void)
+{
+  notifystats_s s;
+
+  pthread_mutex_lock(&nlock);
+  s = stats;
+  pthread_mutex_unlock(&nlock);
+  return s;
+}
+
+/**  @brief Stop the dispatcher after the delivery it is working on. Waiting
+ * notices are discarded.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhNotifyStop(void)
+{
+  if (!running)
+  {
+    return;
+  }
+  pthread_mutex_lock(&nlock);
+  running = 0;
+  pthread_cond_signal(&ncond);
+  pthread_mutex_unlock(&nlock);
+  pthread_join(dispatcher, NULL);
+  if (sockfd != -1)
+  {
+    close(sockfd);
+    sockfd = -1;
+  }
+}
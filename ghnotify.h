@@ -0,0 +1,57 @@
+/**  @brief Alarm notification constants, structures, function prototypes
+ *   @file ghnotify.h
+ */
+#ifndef GHNOTIFY_H
+#define GHNOTIFY_H
+#include "ghjournal.h"
+#include <stdint.h>
+#include <time.h>
+
+#define GHNOTIFYHOOK "./ghnotify.sh"  // run for each notice if executable
+#define GHNOTIFYSOCK "ghnotify.sock"  // datagram socket a consumer may bind
+#define NOTIFYQUEUE 16                // notices waiting for the dispatcher
+#define NOTIFYCODES 32       // alarm codes rate limited separately
+#define NOTIFYGAP 60         // default seconds between notices for one alarm
+#define NOTIFYGAPMAX 86400
+#define NOTIFYRETRIES 5      // failed deliveries retried before giving up
+#define NOTIFYBACKOFFMS 1000 // first retry delay, doubled for each retry
+#define NOTIFYHOOKMS 5000    // longest a hook may run before it is killed
+#define NOTIFYNAMESZ 18
+#define NOTIFYMSGSZ 128
+#define NOTIFYTOSOCK 1       // route bits, set once a route has the notice
+#define NOTIFYTOHOOK 2
+
+typedef struct notice
+{
+  int64_t etime;
+  int32_t code;
+  int32_t type;            // ALARMRAISE or ALARMCLEAR
+  double value;
+  char name[NOTIFYNAMESZ];
+  uint32_t events;         // alarm events folded into this notice
+  uint32_t attempts;       // deliveries tried
+  uint32_t sent;           // routes that already have it
+  uint64_t due;            // monotonic milliseconds it may be sent at
+} notice_s;
+
+typedef struct notifystats
+{
+  uint64_t posted;    // alarm events handed to the dispatcher
+  uint64_t coalesced; // events folded into a waiting notice
+  uint64_t dropped;   // events lost to a full queue
+  uint64_t delivered; // notices taken by every route present
+  uint64_t unrouted;  // notices with neither a hook nor a socket consumer
+  uint64_t retries;   // deliveries tried again after a failure
+  uint64_t failed;    // notices given up after NOTIFYRETRIES
+} notifystats_s;
+
+///@cond INTERNAL
+int GhNotifyStart(int gap);
+void GhNotifyGap(int gap);
+void GhNotifyPost(int code, const char *name, alarmevent_e type, time_t etime,
+                  double value);
+notifystats_s GhNotifyStats(void);
+void GhNotifyStop(void);
+///@endcond
+
+#endif
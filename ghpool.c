@@ -0,0 +1,144 @@
+/**  @brief Code for fixed block memory pools carved at startup from one
+ * static arena, so the controller loop never calls malloc
+ *   @file ghpool.c
+ */
+#include "ghpool.h"
+#include <stdio.h>
+#include <string.h>
+
+static _Alignas(POOLALIGN) unsigned char arena[POOLBUDGET]; // All pool blocks
+static size_t arenaused = 0;                                // Bytes carved
+static pool_s pools[POOLMAX];                               // Pool registry
+static int npools = 0;
+static int sealed = 0; // Set once startup is over
+
+/**  @brief Create a pool of equal sized blocks from the arena. Fails if the
+ * pools together would exceed the memory budget or startup is over.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name short name used in reports.
+ *   @param size bytes per block.
+ *   @param count number of blocks.
+ *   @return the pool, NULL if it does not fit the budget.
+ */
+pool_s *GhPoolCreate(const char *name, size_t size, uint32_t count)
+{
+  pool_s *pool;
+  unsigned char *p;
+  uint32_t i;
+
+  if (size < sizeof(poolblock_s))
+  {
+    size = sizeof(poolblock_s);
+  }
+  size = (size + POOLALIGN - 1) / POOLALIGN * POOLALIGN;
+  if (sealed || npools == POOLMAX || count > (POOLBUDGET - arenaused) / size)
+  {
+    fprintf(stderr, "Memory budget: no room for %u %s blocks of %zu bytes\n",
+            count, name, size);
+    return NULL;
+  }
+  pool = &pools[npools++];
+  snprintf(pool->name, sizeof(pool->name), "%s", name);
+  pool->size = size;
+  pool->capacity = count;
+  p = arena + arenaused;
+  arenaused += size * count;
+  for (i = count; i > 0; i--)
+  {
+    poolblock_s *b = (poolblock_s *)(p + (i - 1) * size);
+    b->next = pool->free;
+    pool->free = b;
+  }
+  return pool;
+}
+
+/**  @brief Take a zeroed block from a pool.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param pool pool to allocate from.
+ *   @return the block, NULL if the pool is empty.
+ */
+void *GhPoolAlloc(pool_s *pool)
+{
+  poolblock_s *b;
+
+  if (pool == NULL || pool->free == NULL)
+  {
+    if (pool != NULL)
+    {
+      pool->failures++;
+    }
+    return NULL;
+  }
+  b = pool->free;
+  pool->free = b->next;
+  if (++pool->inuse > pool->highwater)
+  {
+    pool->highwater = pool->inuse;
+  }
+  memset(b, 0, pool->size);
+  return b;
+}
+
+/**  @brief Return a block to its pool.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param pool pool the block came from.
+ *   @param block block to return, NULL is ignored.
+ *   @return void
+ */
+void GhPoolFree(pool_s *pool, void *block)
+{
+  poolblock_s *b = block;
+
+  if (pool == NULL || b == NULL)
+  {
+    return;
+  }
+  b->next = pool->free;
+  pool->free = b;
+  pool->inuse--;
+}
+
+/**  @brief Mark the end of startup. Later pool creation is refused so the
+ * memory in use is fixed for the life of the controller.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhPoolSeal(void)
+{
+  sealed = 1;
+}
+
+/**  @brief Number of pools created.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return pool count.
+ */
+int GhPoolCount(void)
+{
+  return npools;
+}
+
+/**  @brief Look up a pool for reporting.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param i pool number, 0 to GhPoolCount() - 1.
+ *   @return the pool, NULL if i is out of range.
+ */
+const pool_s *GhPoolGet(int i)
+{
+  return i >= 0 && i < npools ? &pools[i] : NULL;
+}
+
+/**  @brief Bytes of the budget carved into pools.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return bytes in use by pools.
+ */
+size_t GhPoolUsed(void)
+{
+  return arenaused;
+}
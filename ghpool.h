@@ -0,0 +1,41 @@
+/**  @brief Static memory pool constants, structures, function prototypes
+ *   @file ghpool.h
+ */
+#ifndef GHPOOL_H
+#define GHPOOL_H
+#include <stddef.h>
+#include <stdint.h>
+
+#define GHSTATIC 1          // 1 draws controller memory from startup pools
+#define POOLBUDGET 16384    // bytes every pool together may use
+#define POOLMAX 8           // pools that can be created
+#define POOLNAMESZ 16
+#define POOLALIGN 16
+
+typedef struct poolblock
+{
+  struct poolblock *next;
+} poolblock_s;
+
+typedef struct pool
+{
+  char name[POOLNAMESZ];
+  size_t size;        // block size, rounded up to POOLALIGN
+  uint32_t capacity;  // blocks carved at startup
+  uint32_t inuse;     // blocks handed out now
+  uint32_t highwater; // most blocks ever handed out at once
+  uint64_t failures;  // allocations refused because the pool was empty
+  poolblock_s *free;  // free list
+} pool_s;
+
+///@cond INTERNAL
+pool_s *GhPoolCreate(const char *name, size_t size, uint32_t count);
+void *GhPoolAlloc(pool_s *pool);
+void GhPoolFree(pool_s *pool, void *block);
+void GhPoolSeal(void);
+int GhPoolCount(void);
+const pool_s *GhPoolGet(int i);
+size_t GhPoolUsed(void);
+///@endcond
+
+#endif
@@ -0,0 +1,163 @@
+/**  @brief Code for the raw sensor count log. Register values are appended
+ * as fixed size binary records with the calibration they need, so each cycle
+ * costs a copy and conversion to engineering units is left to ghrawconv
+ *   @file ghraw.c
+ */
+#include "ghraw.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static rawrecord_s pending[RAWBUFFER]; // Records not yet written
+static int npending = 0;
+static int rawfd = -1;                  // Raw log file handle
+
+/**  @brief Open the raw log for appending, creating it if needed. Calling it
+ * again while the log is open does nothing.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname raw log file name.
+ *   @param unit serial number stored in a new log.
+ *   @return 1 or 0 depending on whether the log is open.
+ */
+int GhRawOpen(const char *fname, uint64_t unit)
+{
+  rawheader_s hdr = {RAWMAGIC, RAWVERSION, unit};
+  struct stat st;
+  off_t n;
+
+  if (rawfd != -1)
+  {
+    return 1;
+  }
+  npending = 0;
+  rawfd = open(fname, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (rawfd == -1 || fstat(rawfd, &st) == -1)
+  {
+    perror("Error (call to 'open')");
+    GhRawClose();
+    return 0;
+  }
+  if (st.st_size == 0)
+  {
+    if (write(rawfd, &hdr, sizeof(hdr)) != sizeof(hdr))
+    {
+      GhRawClose();
+      return 0;
+    }
+    return 1;
+  }
+  if (pread(rawfd, &hdr, sizeof(hdr), 0) != sizeof(hdr) ||
+      hdr.magic != RAWMAGIC || hdr.version != RAWVERSION)
+  {
+    fprintf(stderr, "%s: not a raw log, raw counts not logged\n", fname);
+    GhRawClose();
+    return 0;
+  }
+
+  // Drop a partially written last record
+  n = (st.st_size - sizeof(hdr)) / sizeof(rawrecord_s);
+  if (sizeof(hdr) + n * sizeof(rawrecord_s) != st.st_size)
+  {
+    ftruncate(rawfd, sizeof(hdr) + n * sizeof(rawrecord_s));
+  }
+  return 1;
+}
+
+/**  @brief Queue one record, writing the queue out first if it is full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param sensor sensor number, 0 to RAWSENSORS - 1.
+ *   @param kind what a and b hold.
+ *   @param rtime time of the measurement.
+ *   @param a first register value.
+ *   @param b second register value.
+ *   @return void
+ */
+void GhRawAdd(int sensor, rawkind_e kind, time_t rtime, int a, int32_t b)
+{
+  rawrecord_s *r;
+
+  if (npending == RAWBUFFER)
+  {
+    GhRawFlush();
+  }
+  r = &pending[npending++];
+  r->rtime = (uint32_t)rtime;
+  r->kind = kind;
+  r->sensor = sensor;
+  r->a = a;
+  r->b = b;
+}
+
+/**  @brief Queue the four calibration points of an HTS221.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param sensor sensor number, 0 to RAWSENSORS - 1.
+ *   @param rtime time the calibration takes effect.
+ *   @param cal calibration read from the sensor.
+ *   @return void
+ */
+void GhRawCalibration(int sensor, time_t rtime, const ht221sCalib_s *cal)
+{
+  GhRawAdd(sensor, RAWCALT0, rtime, cal->t0out, cal->t0degcx8);
+  GhRawAdd(sensor, RAWCALT1, rtime, cal->t1out, cal->t1degcx8);
+  GhRawAdd(sensor, RAWCALH0, rtime, cal->h0out, cal->h0rhx2);
+  GhRawAdd(sensor, RAWCALH1, rtime, cal->h1out, cal->h1rhx2);
+}
+
+/**  @brief Write the queued records in one call. Records are dropped rather
+ * than kept when the write fails, so a bad disk cannot grow the queue.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether every queued record was written.
+ */
+int GhRawFlush(void)
+{
+  ssize_t len = npending * sizeof(rawrecord_s);
+  int ok;
+
+  if (npending == 0)
+  {
+    return 1;
+  }
+  ok = rawfd != -1 && write(rawfd, pending, len) == len;
+  npending = 0;
+  return ok;
+}
+
+/**  @brief Write what is queued and close the raw log.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhRawClose(void)
+{
+  GhRawFlush();
+  if (rawfd != -1)
+  {
+    close(rawfd);
+    rawfd = -1;
+  }
+}
+
+/**  @brief Calibration lines of an HTS221, the same ones ShConvertHTS221
+ * uses, as value = m * counts + c.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param cal calibration points.
+ *   @param m receives the temperature and humidity gradients.
+ *   @param c receives the temperature and humidity intercepts.
+ *   @return void
+ */
+void GhRawLines(const ht221sCalib_s *cal, double m[2], double c[2])
+{
+  double t0 = cal->t0degcx8 / 8.0, t1 = cal->t1degcx8 / 8.0;
+  double h0 = cal->h0rhx2 / 2.0, h1 = cal->h1rhx2 / 2.0;
+
+  m[0] = (t1 - t0) / (cal->t1out - cal->t0out);
+  c[0] = t1 - m[0] * cal->t1out;
+  m[1] = (h1 - h0) / (cal->h1out - cal->h0out);
+  c[1] = h1 - m[1] * cal->h1out;
+}
@@ -0,0 +1,61 @@
+/**  @brief Raw sensor count log constants, structures, function prototypes
+ *   @file ghraw.h
+ */
+#ifndef GHRAW_H
+#define GHRAW_H
+#include "pisensehat.h"
+#include <stdint.h>
+#include <time.h>
+
+#define GHRAWFILE "ghraw.dat"
+#define RAWMAGIC 0x57524847 // "GHRW" little endian
+#define RAWVERSION 1
+#define RAWBUFFER 256       // records held before they are written
+#define RAWSENSORS 256      // sensor numbers a record can carry
+#define RAWLOG RAWLOGOFF    // default raw logging
+
+typedef enum
+{
+  RAWLOGOFF,  // text log only
+  RAWLOGBOTH, // text log and raw log
+  RAWLOGONLY  // raw log only, the text log is not written
+} rawlog_e;
+
+typedef enum
+{
+  RAWHTS221, // a = T_OUT, b = H_OUT
+  RAWLPS25H, // a = TEMP_OUT, b = PRESS_OUT
+  RAWCALT0,  // a = T0_OUT, b = T0_degC_x8
+  RAWCALT1,  // a = T1_OUT, b = T1_degC_x8
+  RAWCALH0,  // a = H0_T0_OUT, b = H0_rH_x2
+  RAWCALH1   // a = H1_T0_OUT, b = H1_rH_x2
+} rawkind_e;
+
+typedef struct rawheader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint64_t unit;
+} rawheader_s;
+
+// One measurement or calibration point as read from the sensor registers.
+// Times are UTC seconds, a calibration applies to the records after it.
+typedef struct rawrecord
+{
+  uint32_t rtime;
+  uint8_t kind;
+  uint8_t sensor;
+  int16_t a;
+  int32_t b;
+} rawrecord_s;
+
+///@cond INTERNAL
+int GhRawOpen(const char *fname, uint64_t unit);
+void GhRawAdd(int sensor, rawkind_e kind, time_t rtime, int a, int32_t b);
+void GhRawCalibration(int sensor, time_t rtime, const ht221sCalib_s *cal);
+int GhRawFlush(void);
+void GhRawClose(void);
+void GhRawLines(const ht221sCalib_s *cal, double m[2], double c[2]);
+///@endcond
+
+#endif
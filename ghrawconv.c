@@ -0,0 +1,259 @@
+/**  @brief Convert ghraw.dat raw count logs to engineering units as CSV. The
+ * records are gathered in batches into flat arrays of counts, gradients and
+ * intercepts and converted by one straight line kernel the compiler can
+ * vectorise. Gains and offsets given on the command line recalibrate the
+ * whole history without touching the logs.
+ *   @file ghrawconv.c
+ */
+#include "ghraw.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define RAWCONVFILE "ghraw.csv"
+#define RAWCONVBATCH 4096 // records converted per kernel call
+
+typedef enum
+{
+  CONVTEMPERATURE,
+  CONVHUMIDITY,
+  CONVPRESSURE,
+  CONVCHANNELS
+} convchannel_e;
+
+// A batch in structure of arrays form, channel 0 is the temperature counts
+// and channel 1 the humidity or pressure counts
+static uint32_t btime[RAWCONVBATCH];
+static uint8_t bsensor[RAWCONVBATCH];
+static uint8_t bkind[RAWCONVBATCH];
+static int32_t bin[2][RAWCONVBATCH];
+static double bm[2][RAWCONVBATCH];
+static double bc[2][RAWCONVBATCH];
+static double bout[2][RAWCONVBATCH];
+
+/**  @brief The conversion kernel, out = m * in + c element by element.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param in counts.
+ *   @param m gradients.
+ *   @param c intercepts.
+ *   @param out receives the values.
+ *   @param n number of elements.
+ *   @return void
+ */
+static void GhRawLinear(const int32_t *restrict in, const double *restrict m,
+                        const double *restrict c, double *restrict out,
+                        size_t n)
+{
+  size_t i;
+
+  for (i = 0; i < n; i++)
+  {
+    out[i] = m[i] * in[i] + c[i];
+  }
+}
+
+/**  @brief Parse a "gain,offset" correction.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg option argument.
+ *   @param gain receives the gain.
+ *   @param offset receives the offset.
+ *   @return 1 or 0 depending on whether arg was valid.
+ */
+static int GhRawCorrection(const char *arg, double *gain, double *offset)
+{
+  char extra;
+
+  return sscanf(arg, "%lf,%lf%c", gain, offset, &extra) == 2;
+}
+
+/**  @brief Convert and print a batch.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param out output stream.
+ *   @param n records in the batch.
+ *   @return void
+ */
+static void GhRawEmit(FILE *out, size_t n)
+{
+  size_t i;
+
+  GhRawLinear(bin[0], bm[0], bc[0], bout[0], n);
+  GhRawLinear(bin[1], bm[1], bc[1], bout[1], n);
+  for (i = 0; i < n; i++)
+  {
+    if (bkind[i] == RAWHTS221)
+    {
+      fprintf(out, "%u,%u,%.2lf,%.2lf,\n", btime[i], bsensor[i], bout[0][i],
+              bout[1][i]);
+    }
+    else
+    {
+      fprintf(out, "%u,%u,%.2lf,,%.2lf\n", btime[i], bsensor[i], bout[0][i],
+              bout[1][i]);
+    }
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  static ht221sCalib_s cal[RAWSENSORS];
+  static double lm[RAWSENSORS][2], lc[RAWSENSORS][2];
+  static int have[RAWSENSORS]; // calibration points seen, one bit each
+  double gain[CONVCHANNELS] = {1, 1, 1}, offset[CONVCHANNELS] = {0};
+  const char *outname = RAWCONVFILE;
+  unsigned long long converted = 0, skipped = 0;
+  const rawheader_s *hdr;
+  const rawrecord_s *rec;
+  struct stat st;
+  size_t n = 0, count, j;
+  FILE *out;
+  void *map;
+  int opt, i, fd, s, ch;
+
+  while ((opt = getopt(argc, argv, "t:h:p:o:")) != -1)
+  {
+    ch = opt == 't'   ? CONVTEMPERATURE
+         : opt == 'h' ? CONVHUMIDITY
+                      : CONVPRESSURE;
+    if (opt == 'o')
+    {
+      outname = optarg;
+    }
+    else if (opt == '?' || !GhRawCorrection(optarg, &gain[ch], &offset[ch]))
+    {
+      fprintf(stderr,
+              "usage: %s [-t gain,offset] [-h gain,offset] [-p gain,offset] "
+              "[-o output] [rawfile...]\n",
+              argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind == argc)
+  {
+    argv[argc++] = GHRAWFILE;
+  }
+  out = strcmp(outname, "-") == 0 ? stdout : fopen(outname, "w");
+  if (out == NULL)
+  {
+    perror(outname);
+    return EXIT_FAILURE;
+  }
+  fprintf(out, "time,sensor,temperature,humidity,pressure\n");
+
+  for (i = optind; i < argc; i++)
+  {
+    fd = open(argv[i], O_RDONLY | O_CLOEXEC);
+    if (fd == -1 || fstat(fd, &st) == -1)
+    {
+      perror(argv[i]);
+      return EXIT_FAILURE;
+    }
+    if ((size_t)st.st_size < sizeof(rawheader_s))
+    {
+      fprintf(stderr, "%s: not a raw log\n", argv[i]);
+      close(fd);
+      continue;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+    {
+      perror(argv[i]);
+      return EXIT_FAILURE;
+    }
+    hdr = map;
+    if (hdr->magic != RAWMAGIC || hdr->version != RAWVERSION)
+    {
+      fprintf(stderr, "%s: not a raw log\n", argv[i]);
+      munmap(map, st.st_size);
+      continue;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+    // Calibration belongs to one unit's sensors, so it starts over per file
+    memset(have, 0, sizeof(have));
+    rec = (const rawrecord_s *)(hdr + 1);
+    count = (st.st_size - sizeof(rawheader_s)) / sizeof(rawrecord_s);
+
+    for (j = 0; j < count; j++)
+    {
+      s = rec[j].sensor;
+      switch (rec[j].kind)
+      {
+      case RAWCALT0:
+        cal[s].t0out = rec[j].a;
+        cal[s].t0degcx8 = rec[j].b;
+        break;
+      case RAWCALT1:
+        cal[s].t1out = rec[j].a;
+        cal[s].t1degcx8 = rec[j].b;
+        break;
+      case RAWCALH0:
+        cal[s].h0out = rec[j].a;
+        cal[s].h0rhx2 = rec[j].b;
+        break;
+      case RAWCALH1:
+        cal[s].h1out = rec[j].a;
+        cal[s].h1rhx2 = rec[j].b;
+        break;
+      case RAWHTS221:
+        if (have[s] != 0xf)
+        {
+          skipped++;
+          continue;
+        }
+        bm[0][n] = lm[s][0] * gain[CONVTEMPERATURE];
+        bc[0][n] = lc[s][0] * gain[CONVTEMPERATURE] + offset[CONVTEMPERATURE];
+        bm[1][n] = lm[s][1] * gain[CONVHUMIDITY];
+        bc[1][n] = lc[s][1] * gain[CONVHUMIDITY] + offset[CONVHUMIDITY];
+        break;
+      case RAWLPS25H:
+        bm[0][n] = gain[CONVTEMPERATURE] / 480.0;
+        bc[0][n] = 42.5 * gain[CONVTEMPERATURE] + offset[CONVTEMPERATURE];
+        bm[1][n] = gain[CONVPRESSURE] / 4096.0;
+        bc[1][n] = offset[CONVPRESSURE];
+        break;
+      default:
+        skipped++;
+        continue;
+      }
+      if (rec[j].kind >= RAWCALT0)
+      {
+        have[s] |= 1 << (rec[j].kind - RAWCALT0);
+        if (have[s] == 0xf)
+        {
+          GhRawLines(&cal[s], lm[s], lc[s]);
+        }
+        continue;
+      }
+      btime[n] = rec[j].rtime;
+      bsensor[n] = s;
+      bkind[n] = rec[j].kind;
+      bin[0][n] = rec[j].a;
+      bin[1][n] = rec[j].b;
+      if (++n == RAWCONVBATCH)
+      {
+        GhRawEmit(out, n);
+        converted += n;
+        n = 0;
+      }
+    }
+    munmap(map, st.st_size);
+  }
+  GhRawEmit(out, n);
+  converted += n;
+
+  if (fflush(out) != 0 || (out != stdout && fclose(out) != 0))
+  {
+    perror(outname);
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%llu records converted, %llu skipped\n", converted,
+          skipped);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,326 @@
+/**  @brief Code for the circular data log, a preallocated file of fixed size
+ * records for units whose flash cannot take an ever growing text log. Each
+ * append is one positioned write into a slot the ring walks through in turn,
+ * so wear is spread over the whole file and the file never grows. Records
+ * carry their sequence number and a CRC, and the header is checkpointed
+ * between two copies, so after a crash the log is recovered by rolling
+ * forward from the newest good header over the records that check out
+ *   @file ghring.c
+ */
+#define _GNU_SOURCE
+#include "ghring.h"
+#include <fcntl.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static int ringfd = -1;      // Ring file handle
+static int writable = 0;     // Set if opened for appending
+static ringheader_s hdr;     // Current header, head and tail kept up to date
+static int unsaved = 0;      // Appends since the last header write
+static int checkpoint = 1;   // Appends between header writes
+
+/**  @brief File offset of the slot a record lives in.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param seq record sequence number, 1 or more.
+ *   @return offset in bytes.
+ */
+static off_t GhRingSlot(uint64_t seq)
+{
+  return 2 * RINGHEADERSZ +
+         (off_t)((seq - 1) % hdr.capacity) * sizeof(ringrecord_s);
+}
+
+/**  @brief Read a record and check that it is the one expected.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param seq record sequence number.
+ *   @param rec receives the record.
+ *   @return 1 if the slot holds record seq intact, otherwise 0.
+ */
+static int GhRingRead(uint64_t seq, ringrecord_s *rec)
+{
+  if (pread(ringfd, rec, sizeof(*rec), GhRingSlot(seq)) != sizeof(*rec))
+  {
+    return 0;
+  }
+  return rec->seq == seq &&
+         rec->crc == crc32(0, (const Bytef *)rec, offsetof(ringrecord_s, crc));
+}
+
+/**  @brief Load the newer good header copy and roll forward over records
+ * written after it was saved.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the file is a ring.
+ */
+static int GhRingLoad(void)
+{
+  ringheader_s copy[2];
+  ringrecord_s rec;
+  int i, best = -1;
+  uint32_t n;
+
+  for (i = 0; i < 2; i++)
+  {
+    if (pread(ringfd, &copy[i], sizeof(copy[i]), i * RINGHEADERSZ) !=
+            sizeof(copy[i]) ||
+        copy[i].magic != RINGMAGIC || copy[i].version != RINGVERSION ||
+        copy[i].recsize != sizeof(ringrecord_s) || copy[i].capacity == 0 ||
+        copy[i].head < copy[i].tail ||
+        copy[i].head - copy[i].tail > copy[i].capacity ||
+        copy[i].crc != crc32(0, (const Bytef *)&copy[i],
+                             offsetof(ringheader_s, crc)))
+    {
+      continue;
+    }
+    if (best == -1 || copy[i].gen > copy[best].gen)
+    {
+      best = i;
+    }
+  }
+  if (best == -1)
+  {
+    return 0;
+  }
+  hdr = copy[best];
+  for (n = 0; n < hdr.capacity && GhRingRead(hdr.head, &rec); n++)
+  {
+    hdr.head++;
+  }
+  if (hdr.head - hdr.tail > hdr.capacity)
+  {
+    hdr.tail = hdr.head - hdr.capacity;
+  }
+  return 1;
+}
+
+/**  @brief Write the header over the older of its two copies.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the copy was written.
+ */
+static int GhRingSave(void)
+{
+  hdr.gen++;
+  hdr.crc = crc32(0, (const Bytef *)&hdr, offsetof(ringheader_s, crc));
+  if (pwrite(ringfd, &hdr, sizeof(hdr), (hdr.gen % 2) * RINGHEADERSZ) !=
+      sizeof(hdr))
+  {
+    return 0;
+  }
+  unsaved = 0;
+  return 1;
+}
+
+/**  @brief Open the ring for appending, creating and preallocating it if
+ * needed. Calling it again while the ring is open does nothing.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname ring file name.
+ *   @param capacity records a new ring holds, an existing ring keeps its own.
+ *   @param unit serial number stored in a new ring.
+ *   @return 1 or 0 depending on whether the ring is open.
+ */
+int GhRingOpen(const char *fname, uint32_t capacity, uint64_t unit)
+{
+  ringheader_s fresh = {RINGMAGIC, RINGVERSION, capacity,
+                        sizeof(ringrecord_s), unit, 0, 1, 1, 0, 0};
+  struct stat st;
+
+  if (ringfd != -1 && writable)
+  {
+    return 1;
+  }
+  GhRingClose();
+  ringfd = open(fname, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (ringfd == -1 || fstat(ringfd, &st) == -1)
+  {
+    perror("Error (call to 'open')");
+    GhRingClose();
+    return 0;
+  }
+  if (st.st_size == 0)
+  {
+    if (capacity == 0 ||
+        posix_fallocate(ringfd, 0,
+                        2 * RINGHEADERSZ +
+                            (off_t)capacity * sizeof(ringrecord_s)) != 0)
+    {
+      GhRingClose();
+      unlink(fname);
+      return 0;
+    }
+    hdr = fresh;
+    // Both copies start out valid so either can be overwritten first
+    if (!GhRingSave() || !GhRingSave() || fsync(ringfd) != 0)
+    {
+      GhRingClose();
+      unlink(fname);
+      return 0;
+    }
+  }
+  else if (!GhRingLoad())
+  {
+    fprintf(stderr, "%s: not a data ring, readings not logged\n", fname);
+    GhRingClose();
+    return 0;
+  }
+  else if (hdr.capacity != capacity)
+  {
+    fprintf(stderr, "%s: keeping its capacity of %u records\n", fname,
+            hdr.capacity);
+  }
+  // Roll forward finds unsaved records only while none has been overwritten
+  checkpoint = hdr.capacity / 2 < RINGCHECKPOINT ? hdr.capacity / 2
+                                                 : RINGCHECKPOINT;
+  checkpoint = checkpoint < 1 ? 1 : checkpoint;
+  writable = 1;
+  unsaved = 0;
+  return 1;
+}
+
+/**  @brief Open an existing ring read only to iterate over it from another
+ * process. The records seen are those held when it was attached.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname ring file name.
+ *   @return 1 or 0 depending on whether the file is a ring.
+ */
+int GhRingAttach(const char *fname)
+{
+  GhRingClose();
+  ringfd = open(fname, O_RDONLY | O_CLOEXEC);
+  if (ringfd == -1)
+  {
+    return 0;
+  }
+  if (!GhRingLoad())
+  {
+    GhRingClose();
+    return 0;
+  }
+  return 1;
+}
+
+/**  @brief Append one reading, overwriting the oldest record once the ring is
+ * full. The header is saved every RINGCHECKPOINT appends, or every half
+ * capacity for a smaller ring.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rtime time of the reading.
+ *   @param value temperature, humidity and pressure.
+ *   @return 1 or 0 depending on whether the record was written.
+ */
+int GhRingAppend(time_t rtime, const double value[LOGFIELDS])
+{
+  ringrecord_s rec;
+  int i;
+
+  if (ringfd == -1 || !writable)
+  {
+    return 0;
+  }
+  rec.seq = hdr.head;
+  rec.rtime = rtime;
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    rec.value[i] =
+        isnan(value[i]) ? RINGMISSING : (int32_t)lround(value[i] * 10);
+  }
+  rec.crc = crc32(0, (const Bytef *)&rec, offsetof(ringrecord_s, crc));
+  if (pwrite(ringfd, &rec, sizeof(rec), GhRingSlot(rec.seq)) != sizeof(rec))
+  {
+    return 0;
+  }
+  hdr.head++;
+  if (hdr.head - hdr.tail > hdr.capacity)
+  {
+    hdr.tail = hdr.head - hdr.capacity;
+  }
+  if (++unsaved >= checkpoint)
+  {
+    return GhRingSync();
+  }
+  return 1;
+}
+
+/**  @brief Make the appended records durable, then save the header. A crash
+ * in between is covered by the roll forward when the ring is next opened.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 or 0 depending on whether the records and header were written.
+ */
+int GhRingSync(void)
+{
+  if (ringfd == -1 || !writable)
+  {
+    return 0;
+  }
+  if (unsaved == 0)
+  {
+    return 1;
+  }
+  return fdatasync(ringfd) == 0 && GhRingSave();
+}
+
+/**  @brief Header of the open ring.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return copy of the header, head and tail as of the last append.
+ */
+ringheader_s GhRingHeader(void)
+{
+  return hdr;
+}
+
+/**  @brief Iterate from oldest to newest. Start with *seq at 0, each call
+ * returns the next intact record. Slots that fail their check are skipped.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param seq cursor, advanced past the record returned.
+ *   @param rec receives the record.
+ *   @return 1 if a record was returned, 0 at the newest.
+ */
+int GhRingNext(uint64_t *seq, ringrecord_s *rec)
+{
+  if (ringfd == -1)
+  {
+    return 0;
+  }
+  if (*seq < hdr.tail)
+  {
+    *seq = hdr.tail;
+  }
+  while (*seq < hdr.head)
+  {
+    if (GhRingRead((*seq)++, rec))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**  @brief Save the header if appends are pending and close the ring.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhRingClose(void)
+{
+  if (ringfd != -1)
+  {
+    if (writable)
+    {
+      GhRingSync();
+    }
+    close(ringfd);
+    ringfd = -1;
+  }
+  writable = 0;
+}
@@ -0,0 +1,55 @@
+/**  @brief Circular data log constants, structures, function prototypes
+ *   @file ghring.h
+ */
+#ifndef GHRING_H
+#define GHRING_H
+#include "ghlog.h"
+#include <stdint.h>
+#include <time.h>
+
+#define GHRINGFILE "ghdata.ring"
+#define RINGMAGIC 0x47524847    // "GHRG" little endian
+#define RINGVERSION 1
+#define RINGRECORDS 0           // default capacity, 0 keeps the text log
+#define RINGRECORDSMAX 4194304  // 128 MB of records
+#define RINGHEADERSZ 512        // each header copy has a sector to itself
+#define RINGCHECKPOINT 1024     // most appends between header writes
+#define RINGMISSING INT32_MIN   // value of a NAN reading
+
+// Two copies are kept and written in turn, the valid one with the larger
+// generation is current. Sequence numbers count every record ever written,
+// record seq lives in slot (seq - 1) % capacity.
+typedef struct ringheader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t capacity;  // record slots
+  uint32_t recsize;
+  uint64_t unit;      // serial of the logging unit
+  uint64_t gen;       // header writes
+  uint64_t tail;      // seq of the oldest record held
+  uint64_t head;      // seq the next record gets
+  uint32_t crc;       // CRC-32 of the fields above
+  uint32_t pad;
+} ringheader_s;
+
+// Times are UTC seconds
+typedef struct ringrecord
+{
+  uint64_t seq;
+  int64_t rtime;
+  int32_t value[LOGFIELDS]; // tenths of a unit, RINGMISSING if unknown
+  uint32_t crc;             // CRC-32 of the fields above
+} ringrecord_s;
+
+///@cond INTERNAL
+int GhRingOpen(const char *fname, uint32_t capacity, uint64_t unit);
+int GhRingAttach(const char *fname);
+int GhRingAppend(time_t rtime, const double value[LOGFIELDS]);
+int GhRingSync(void);
+ringheader_s GhRingHeader(void);
+int GhRingNext(uint64_t *seq, ringrecord_s *rec);
+void GhRingClose(void);
+///@endcond
+
+#endif
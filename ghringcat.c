@@ -0,0 +1,67 @@
+/**  @brief Print a circular data log oldest to newest in the ghdata.txt
+ * format, so the text log tools can read it
+ *   @file ghringcat.c
+ */
+#include "ghring.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+int main(int argc, char *argv[])
+{
+  unsigned long long held, printed = 0;
+  double value[LOGFIELDS];
+  char line[LOGRECORDSZ];
+  logstamp_s stamp = {0};
+  const char *fname;
+  ringheader_s hdr;
+  ringrecord_s rec;
+  uint64_t seq = 0;
+  FILE *out = stdout;
+  int opt, i;
+
+  while ((opt = getopt(argc, argv, "o:")) != -1)
+  {
+    if (opt != 'o')
+    {
+      fprintf(stderr, "usage: %s [-o output] [ringfile]\n", argv[0]);
+      return EXIT_FAILURE;
+    }
+    out = fopen(optarg, "w");
+    if (out == NULL)
+    {
+      perror(optarg);
+      return EXIT_FAILURE;
+    }
+  }
+  fname = optind < argc ? argv[optind] : GHRINGFILE;
+  if (!GhRingAttach(fname))
+  {
+    fprintf(stderr, "%s: not a data ring\n", fname);
+    return EXIT_FAILURE;
+  }
+  hdr = GhRingHeader();
+
+  while (GhRingNext(&seq, &rec))
+  {
+    for (i = 0; i < LOGFIELDS; i++)
+    {
+      value[i] = rec.value[i] == RINGMISSING ? NAN : rec.value[i] / 10.0;
+    }
+    fwrite(line, 1, GhLogFormat(line, &stamp, rec.rtime, value, hdr.unit),
+           out);
+    printed++;
+  }
+  GhRingClose();
+
+  held = hdr.head - hdr.tail;
+  if (fflush(out) != 0 || (out != stdout && fclose(out) != 0))
+  {
+    perror("write");
+    return EXIT_FAILURE;
+  }
+  fprintf(stderr, "%llu of %llu records, %u slots\n", printed, held,
+          hdr.capacity);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,383 @@
+/**  @brief Code for rotating the data log and compressing closed segments on
+ * a low priority background thread
+ *   @file ghrotate.c
+ */
+#define _GNU_SOURCE
+#include "ghrotate.h"
+#include "ghindex.h"
+#include <dirent.h>
+#include <fcntl.h>
+#include <libgen.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+static pthread_t worker;                            // Compression thread
+static int running = 0;                             // Set while worker runs
+static pthread_mutex_t qlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t qcond = PTHREAD_COND_INITIALIZER;
+static char queue[ROTATEQUEUE][ROTATENAMESZ];       // Segments to compress
+static int qhead = 0, qcount = 0;
+static rotatepolicy_s rpolicy = {ROTATESIZEKB, ROTATENONE, ROTATERETAIN};
+static char segdir[ROTATENAMESZ];                   // Directory of the log
+static char segprefix[ROTATENAMESZ];                // "ghdata-" for ghdata.txt
+static long segperiod = -1;                         // Period of open segment
+
+/**  @brief Calendar period a time falls in under the current policy.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param t time to classify.
+ *   @return period key, 0 when periodic rotation is off.
+ */
+static long GhRotatePeriod(time_t t)
+{
+  struct tm tm;
+  localtime_r(&t, &tm);
+  if (rpolicy.period == ROTATEDAILY)
+  {
+    return tm.tm_year * 1000L + tm.tm_yday;
+  }
+  if (rpolicy.period == ROTATEMONTHLY)
+  {
+    return tm.tm_year * 12L + tm.tm_mon;
+  }
+  return 0;
+}
+
+/**  @brief Delete the oldest closed segments beyond the retention count.
+ * The newest names are kept in order while the directory is read, and a
+ * name dropping out of them is deleted at once, so any number of segments is
+ * handled in fixed memory.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param retain number of segments to keep, at most ROTATEMAXSEGS.
+ *   @return void
+ */
+static void GhRotateRetain(int retain)
+{
+  static char names[ROTATEMAXSEGS][ROTATENAMESZ];
+  char path[2 * ROTATENAMESZ];
+  struct dirent *de;
+  DIR *dir;
+  int n = 0, i;
+
+  retain = retain > ROTATEMAXSEGS ? ROTATEMAXSEGS : retain;
+  dir = opendir(segdir);
+  if (dir == NULL)
+  {
+    return;
+  }
+  while ((de = readdir(dir)) != NULL)
+  {
+    if (strncmp(de->d_name, segprefix, strlen(segprefix)) != 0)
+    {
+      continue;
+    }
+    // Names sort by the time they were closed, oldest first
+    for (i = n; i > 0 && strcmp(names[i - 1], de->d_name) > 0; i--)
+    {
+    }
+    if (n == retain && i == 0)
+    {
+      snprintf(path, sizeof(path), "%s/%s", segdir, de->d_name);
+      unlink(path);
+      continue;
+    }
+    if (n == retain)
+    {
+      snprintf(path, sizeof(path), "%s/%s", segdir, names[0]);
+      unlink(path);
+      memmove(names[0], names[1], (size_t)(i - 1) * sizeof(names[0]));
+      i--;
+    }
+    else
+    {
+      memmove(names[i + 1], names[i], (size_t)(n - i) * sizeof(names[0]));
+      n++;
+    }
+    snprintf(names[i], sizeof(names[i]), "%s", de->d_name);
+  }
+  closedir(dir);
+}
+
+/**  @brief Gzip a closed segment and remove the original.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name segment file name.
+ *   @return 1 or 0 depending on whether the segment was compressed.
+ */
+static int GhRotateCompress(const char *name)
+{
+  char gzname[ROTATENAMESZ + 4];
+  char buf[ROTATECHUNK];
+  ssize_t n;
+  gzFile gz;
+  int fd;
+
+  fd = open(name, O_RDONLY);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  snprintf(gzname, sizeof(gzname), "%s.gz", name);
+  gz = gzopen(gzname, "wb6");
+  if (gz == NULL)
+  {
+    close(fd);
+    return 0;
+  }
+  while ((n = read(fd, buf, sizeof(buf))) > 0)
+  {
+    if (gzwrite(gz, buf, n) != n)
+    {
+      n = -1;
+      break;
+    }
+  }
+  close(fd);
+  if (gzclose(gz) != Z_OK || n < 0)
+  {
+    unlink(gzname);
+    return 0;
+  }
+  unlink(name);
+  return 1;
+}
+
+/**  @brief Background thread compressing queued segments at idle priority.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg unused.
+ *   @return NULL
+ */
+static void *GhRotateWorker(void *arg)
+{
+  struct sched_param sp = {0};
+  char name[ROTATENAMESZ];
+  int retain;
+
+  pthread_setschedparam(pthread_self(), SCHED_IDLE, &sp);
+  setpriority(PRIO_PROCESS, gettid(), 19);
+  pthread_mutex_lock(&qlock);
+  while (running)
+  {
+    if (qcount == 0)
+    {
+      pthread_cond_wait(&qcond, &qlock);
+      continue;
+    }
+    snprintf(name, sizeof(name), "%s", queue[qhead]);
+    qhead = (qhead + 1) % ROTATEQUEUE;
+    qcount--;
+    retain = rpolicy.retain;
+    pthread_mutex_unlock(&qlock);
+
+    GhRotateCompress(name);
+    GhRotateRetain(retain);
+
+    pthread_mutex_lock(&qlock);
+  }
+  pthread_mutex_unlock(&qlock);
+  return NULL;
+}
+
+/**  @brief Queue a closed segment for compression without waiting.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name segment file name.
+ *   @return 1 if queued, 0 if the queue is full.
+ */
+static int GhRotateQueue(const char *name)
+{
+  int ok = 0;
+
+  pthread_mutex_lock(&qlock);
+  if (qcount < ROTATEQUEUE)
+  {
+    snprintf(queue[(qhead + qcount) % ROTATEQUEUE], ROTATENAMESZ, "%s", name);
+    qcount++;
+    ok = 1;
+    pthread_cond_signal(&qcond);
+  }
+  pthread_mutex_unlock(&qlock);
+  return ok;
+}
+
+/**  @brief Start the compression thread and queue segments left uncompressed
+ * by an earlier run.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @param policy rotation policy.
+ *   @return 1 or 0 depending on whether the thread started.
+ */
+int GhRotateInit(const char *logname, rotatepolicy_s policy)
+{
+  char buf[ROTATENAMESZ], path[2 * ROTATENAMESZ];
+  struct dirent *de;
+  struct stat st;
+  char *dot;
+  DIR *dir;
+
+  rpolicy = policy;
+  snprintf(buf, sizeof(buf), "%s", logname);
+  snprintf(segdir, sizeof(segdir), "%s", dirname(buf));
+  snprintf(buf, sizeof(buf), "%s", logname);
+  snprintf(segprefix, sizeof(segprefix), "%s", basename(buf));
+  dot = strrchr(segprefix, '.');
+  if (dot != NULL)
+  {
+    *dot = '\0';
+  }
+  strncat(segprefix, "-", sizeof(segprefix) - strlen(segprefix) - 1);
+  segperiod = stat(logname, &st) == 0 ? GhRotatePeriod(st.st_mtime) : -1;
+
+  running = 1;
+  if (pthread_create(&worker, NULL, GhRotateWorker, NULL) != 0)
+  {
+    running = 0;
+    return 0;
+  }
+  dir = opendir(segdir);
+  if (dir != NULL)
+  {
+    while ((de = readdir(dir)) != NULL)
+    {
+      size_t len = strlen(de->d_name);
+      if (strncmp(de->d_name, segprefix, strlen(segprefix)) == 0 && len > 3 &&
+          strcmp(de->d_name + len - 3, ".gz") != 0)
+      {
+        snprintf(path, sizeof(path), "%s/%s", segdir, de->d_name);
+        GhRotateQueue(path);
+      }
+    }
+    closedir(dir);
+  }
+  return 1;
+}
+
+/**  @brief Replace the rotation policy, for example after a config reload.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param policy new rotation policy.
+ *   @return void
+ */
+void GhRotatePolicy(rotatepolicy_s policy)
+{
+  pthread_mutex_lock(&qlock);
+  if (policy.period != rpolicy.period)
+  {
+    segperiod = -1;
+  }
+  rpolicy = policy;
+  pthread_mutex_unlock(&qlock);
+}
+
+/**  @brief Build an unused segment name for a time. A name already taken by a
+ * segment closed in the same second, compressed or not, gets a sequence
+ * suffix that sorts after it.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param segname buffer receiving the name.
+ *   @param size capacity of segname.
+ *   @param now time the segment is closed.
+ *   @return 1 or 0 depending on whether an unused name was found.
+ */
+static int GhRotateName(char *segname, size_t size, time_t now)
+{
+  char stamp[32], gzname[2 * ROTATENAMESZ + 4];
+  struct tm tm;
+  int seq;
+
+  localtime_r(&now, &tm);
+  strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm);
+  for (seq = 0; seq <= ROTATEMAXSEQ; seq++)
+  {
+    if (seq == 0)
+    {
+      snprintf(segname, size, "%s/%s%s.txt", segdir, segprefix, stamp);
+    }
+    else
+    {
+      snprintf(segname, size, "%s/%s%s_%02d.txt", segdir, segprefix, stamp,
+               seq);
+    }
+    snprintf(gzname, sizeof(gzname), "%s.gz", segname);
+    if (access(segname, F_OK) != 0 && access(gzname, F_OK) != 0)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**  @brief Close the current log segment if it has reached the size limit or
+ * a new calendar period has started. Compression happens in the background.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param logname data log file name.
+ *   @param now time of the record about to be logged.
+ *   @return 1 if the log was rotated, 0 otherwise.
+ */
+int GhRotateCheck(const char *logname, time_t now)
+{
+  char segname[2 * ROTATENAMESZ], idxname[INDEXNAMESZ];
+  struct stat st;
+  long period = GhRotatePeriod(now);
+  int due;
+
+  if (stat(logname, &st) == -1)
+  {
+    segperiod = period;
+    return 0;
+  }
+  if (segperiod == -1)
+  {
+    segperiod = period;
+  }
+  due = (rpolicy.sizekb > 0 && st.st_size >= (off_t)rpolicy.sizekb * 1024) ||
+        (rpolicy.period != ROTATENONE && period != segperiod);
+  if (!due)
+  {
+    return 0;
+  }
+
+  if (!GhRotateName(segname, sizeof(segname), now) ||
+      rename(logname, segname) != 0)
+  {
+    return 0;
+  }
+  GhIndexName(logname, idxname, sizeof(idxname));
+  unlink(idxname);
+  GhIndexReset();
+  segperiod = period;
+  if (running)
+  {
+    // A full queue leaves the segment uncompressed until the next start
+    GhRotateQueue(segname);
+  }
+  return 1;
+}
+
+/**  @brief Stop the compression thread after the segment it is working on.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhRotateClose(void)
+{
+  if (!running)
+  {
+    return;
+  }
+  pthread_mutex_lock(&qlock);
+  running = 0;
+  pthread_cond_signal(&qcond);
+  pthread_mutex_unlock(&qlock);
+  pthread_join(worker, NULL);
+}
@@ -0,0 +1,37 @@
+/**  @brief Data log rotation constants, structures, function prototypes
+ *   @file ghrotate.h
+ */
+#ifndef GHROTATE_H
+#define GHROTATE_H
+#include <time.h>
+
+#define ROTATENAMESZ 256
+#define ROTATEQUEUE 8
+#define ROTATEMAXSEGS 512  // most segments rotateretain may keep
+#define ROTATECHUNK 16384
+#define ROTATESIZEKB 10240
+#define ROTATERETAIN 30
+#define ROTATEMAXSEQ 99    // segments closed within the same second
+
+typedef enum
+{
+  ROTATENONE,
+  ROTATEDAILY,
+  ROTATEMONTHLY
+} rotateperiod_e;
+
+typedef struct rotatepolicy
+{
+  int sizekb; // rotate once the log reaches this size, 0 disables
+  int period; // rotateperiod_e calendar boundary to rotate on
+  int retain; // closed segments kept, oldest are deleted first
+} rotatepolicy_s;
+
+///@cond INTERNAL
+int GhRotateInit(const char *logname, rotatepolicy_s policy);
+void GhRotatePolicy(rotatepolicy_s policy);
+int GhRotateCheck(const char *logname, time_t now);
+void GhRotateClose(void);
+///@endcond
+
+#endif
@@ -0,0 +1,254 @@
+/**  @brief Code for the multi-rate task scheduler. Tasks run at their own
+ * period and phase off a hashed timer wheel, and the caller sleeps once
+ * until the earliest of them is due
+ *   @file ghsched.c
+ */
+#include "ghsched.h"
+#include "ghtrace.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+static schedtask_s tasks[SCHEDTASKS]; // Registered tasks, run in this order
+static int ntasks = 0;
+static int slots[SCHEDSLOTS];         // First task waiting in each slot
+static uint64_t origin;               // Monotonic milliseconds at time 0
+static uint64_t cursor = 0;           // Next tick to expire
+static int current = -1;              // Task running now, not on the wheel
+
+/**  @brief Read the scheduler clock.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return milliseconds since the first task was added.
+ */
+static uint64_t GhSchedClock(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000 - origin;
+}
+
+/**  @brief Put a task in the slot of the first tick at or after its due
+ * time. A time already past goes in the next tick to expire.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param id task number.
+ *   @return void
+ */
+static void GhSchedInsert(int id)
+{
+  schedtask_s *t = &tasks[id];
+  int s;
+
+  t->tick = (t->due + SCHEDTICKMS - 1) / SCHEDTICKMS;
+  if (t->tick < cursor)
+  {
+    t->tick = cursor;
+  }
+  s = t->tick % SCHEDSLOTS;
+  t->next = slots[s];
+  slots[s] = id;
+}
+
+/**  @brief Take a task out of its slot.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param id task number.
+ *   @return void
+ */
+static void GhSchedRemove(int id)
+{
+  int *link = &slots[tasks[id].tick % SCHEDSLOTS];
+
+  while (*link != -1 && *link != id)
+  {
+    link = &tasks[*link].next;
+  }
+  if (*link == id)
+  {
+    *link = tasks[id].next;
+  }
+}
+
+/**  @brief Register a periodic task. Tasks due in the same tick run in the
+ * order they were added, so producers should be added before consumers.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name label used in traces and metrics.
+ *   @param period milliseconds between runs.
+ *   @param phase milliseconds from now to the first run.
+ *   @param fn task body.
+ *   @param arg passed to fn.
+ *   @return task number, -1 if the table is full.
+ */
+int GhSchedAdd(const char *name, int period, int phase, void (*fn)(void *),
+               void *arg)
+{
+  schedtask_s *t;
+
+  if (ntasks == SCHEDTASKS)
+  {
+    return -1;
+  }
+  if (ntasks == 0)
+  {
+    memset(slots, -1, sizeof(slots));
+    origin = 0;
+    origin = GhSchedClock();
+  }
+  t = &tasks[ntasks];
+  snprintf(t->name, sizeof(t->name), "%s", name);
+  t->fn = fn;
+  t->arg = arg;
+  t->period = period < SCHEDTICKMS ? SCHEDTICKMS : period;
+  t->due = GhSchedClock() + (phase < 0 ? 0 : phase);
+  GhSchedInsert(ntasks);
+  return ntasks++;
+}
+
+/**  @brief Change a task's period. The next run moves to one new period
+ * after the last, or to now if that has passed. A task may change its own
+ * period while it runs.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param id task number.
+ *   @param period milliseconds between runs.
+ *   @return void
+ */
+void GhSchedPeriod(int id, int period)
+{
+  schedtask_s *t;
+  int64_t due;
+
+  if (id < 0 || id >= ntasks)
+  {
+    return;
+  }
+  t = &tasks[id];
+  period = period < SCHEDTICKMS ? SCHEDTICKMS : period;
+  if (period == t->period)
+  {
+    return;
+  }
+  if (id == current)
+  {
+    // GhSchedRun schedules it from the new period once it returns
+    t->period = period;
+    return;
+  }
+  GhSchedRemove(id);
+  due = (int64_t)t->due - t->period + period;
+  t->period = period;
+  t->due = due > (int64_t)GhSchedClock() ? (uint64_t)due : GhSchedClock();
+  GhSchedInsert(id);
+}
+
+/**  @brief Expire every tick up to now and run the tasks that are due, each
+ * once, in the order they were added. A task that fell a whole period or
+ * more behind skips the runs it missed rather than running them back to
+ * back.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return number of tasks run.
+ */
+int GhSchedRun(void)
+{
+  uint64_t now = GhSchedClock(), nowtick = now / SCHEDTICKMS, c, start;
+  uint32_t due = 0;
+  int i, id, *link, run = 0;
+
+  // After a long stall one revolution already visits every slot
+  c = nowtick + 1 - cursor > SCHEDSLOTS ? nowtick + 1 - SCHEDSLOTS : cursor;
+  for (; c <= nowtick; c++)
+  {
+    link = &slots[c % SCHEDSLOTS];
+    while (*link != -1)
+    {
+      id = *link;
+      if (tasks[id].tick <= nowtick)
+      {
+        *link = tasks[id].next;
+        due |= 1u << id;
+      }
+      else
+      {
+        link = &tasks[id].next;
+      }
+    }
+  }
+  cursor = nowtick + 1;
+
+  for (i = 0; i < ntasks; i++)
+  {
+    schedtask_s *t = &tasks[i];
+    if (!(due & (1u << i)))
+    {
+      continue;
+    }
+    current = i;
+    start = GhSchedClock();
+    GhTraceBegin(t->name, t->period);
+    t->fn(t->arg);
+    GhTraceEnd(t->name);
+    current = -1;
+    now = GhSchedClock();
+    t->maxms = now - start > t->maxms ? now - start : t->maxms;
+    t->runs++;
+    run++;
+
+    t->due += t->period;
+    if (t->due <= now)
+    {
+      uint64_t missed = (now - t->due) / t->period + 1;
+      t->skipped += missed;
+      t->due += missed * t->period;
+    }
+    GhSchedInsert(i);
+  }
+  return run;
+}
+
+/**  @brief Time until the next task is due, found by walking the wheel
+ * from the next tick to expire.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return milliseconds to sleep, at most one wheel revolution.
+ */
+int GhSchedWait(void)
+{
+  uint64_t now = GhSchedClock(), c;
+  int id;
+
+  for (c = cursor; c < cursor + SCHEDSLOTS; c++)
+  {
+    for (id = slots[c % SCHEDSLOTS]; id != -1; id = tasks[id].next)
+    {
+      if (tasks[id].tick == c)
+      {
+        return c * SCHEDTICKMS > now ? (int)(c * SCHEDTICKMS - now) : 0;
+      }
+    }
+  }
+  return SCHEDSLOTS * SCHEDTICKMS;
+}
+
+/**  @brief Number of registered tasks.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return task count.
+ */
+int GhSchedCount(void)
+{
+  return ntasks;
+}
+
+/**  @brief Look up a task for reporting.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param i task number, 0 to GhSchedCount() - 1.
+ *   @return the task, NULL if i is out of range.
+ */
+const schedtask_s *GhSchedGet(int i)
+{
+  return i >= 0 && i < ntasks ? &tasks[i] : NULL;
+}
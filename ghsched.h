@@ -0,0 +1,45 @@
+/**  @brief Task scheduler constants, structures, function prototypes
+ *   @file ghsched.h
+ */
+#ifndef GHSCHED_H
+#define GHSCHED_H
+#include <stdint.h>
+
+#define SCHEDTICKMS 50   // wheel resolution, tasks never run early
+#define SCHEDSLOTS 256   // wheel slots, one revolution is 12.8 seconds
+#define SCHEDTASKS 16
+#define SCHEDNAMESZ 16
+#define SCHEDCONFIGMS 1000    // controller task periods
+#define SCHEDPRESSUREMS 10000
+#define SCHEDCONTROLMS 500
+#define SCHEDALARMMS 1000
+#define SCHEDPUBLISHMS 1000
+#define SCHEDLOGMS 60000      // text log batches, the history must hold one
+#define SCHEDDISPLAYMS 5000
+#define SCHEDHOUSEMS 60000
+
+typedef struct schedtask
+{
+  char name[SCHEDNAMESZ];
+  void (*fn)(void *arg);
+  void *arg;
+  int period;         // milliseconds between runs
+  uint64_t due;       // scheduler time of the next run
+  uint64_t tick;      // wheel tick the task waits for
+  int next;           // next task in the same slot, -1 ends the list
+  uint64_t runs;
+  uint64_t skipped;   // periods missed because a run started late
+  uint64_t maxms;     // longest run
+} schedtask_s;
+
+///@cond INTERNAL
+int GhSchedAdd(const char *name, int period, int phase, void (*fn)(void *),
+               void *arg);
+void GhSchedPeriod(int id, int period);
+int GhSchedRun(void);
+int GhSchedWait(void);
+int GhSchedCount(void);
+const schedtask_s *GhSchedGet(int i);
+///@endcond
+
+#endif
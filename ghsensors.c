@@ -0,0 +1,452 @@
+/**  @brief Code for the sensor registry. Sensors on many I2C buses are
+ * listed in ghsensors.txt and each bus is polled by its own worker thread,
+ * so the buses are read concurrently and combined into one reading
+ *   @file ghsensors.c
+ */
+#include "ghsensors.h"
+#include "ghraw.h"
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static sensor_s sensors[SENSORMAX];     // Every registered sensor
+static int nsensors = 0;
+static sensorbus_s buses[SENSORBUSMAX]; // One worker per bus
+static int nbuses = 0;
+static int running = 0;                 // Cleared to stop the workers
+static uint64_t generation = 0;         // Sample being taken
+static int pending = 0;                 // Buses still working on it
+static unsigned wanted = SENSORALL;     // Models measured in this sample
+static pthread_mutex_t slock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t work = PTHREAD_COND_INITIALIZER; // Signals a new sample
+static pthread_cond_t done;                            // Signals a bus finished
+static uint32_t rawcal[SENSORMAX];      // Calibration last put in the raw log
+
+/**  @brief Add a sensor to the registry, adding its bus on first use.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param path I2C bus device.
+ *   @param addr I2C address.
+ *   @param type sensor model.
+ *   @param name label used in reports.
+ *   @return 1 if added, 0 if a table is full.
+ */
+static int GhSensorsAdd(const char *path, int addr, sensortype_e type,
+                        const char *name)
+{
+  sensor_s *s;
+  int b;
+
+  for (b = 0; b < nbuses && strcmp(buses[b].path, path) != 0; b++)
+    ;
+  if (nsensors == SENSORMAX || (b == nbuses && nbuses == SENSORBUSMAX))
+  {
+    return 0;
+  }
+  if (b == nbuses)
+  {
+    snprintf(buses[b].path, sizeof(buses[b].path), "%s", path);
+    nbuses++;
+  }
+  s = &sensors[nsensors];
+  snprintf(s->name, sizeof(s->name), "%s", name);
+  s->bus = b;
+  s->addr = addr;
+  s->type = type;
+  s->fd = -1;
+  buses[b].sensor[buses[b].nsensors++] = nsensors++;
+  return 1;
+}
+
+/**  @brief Read the registry file. Each line holds a bus device, an address,
+ * a model and an optional name, for example "/dev/i2c-1 0x5f hts221 bench".
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname registry file name.
+ *   @return number of sensors read, -1 if the file cannot be opened.
+ */
+static int GhSensorsParse(const char *fname)
+{
+  char buf[128], path[SENSORPATHSZ], model[16], name[SENSORNAMESZ];
+  sensortype_e type;
+  unsigned addr;
+  int n, lineno = 0;
+  FILE *fp;
+
+  fp = fopen(fname, "r");
+  if (fp == NULL)
+  {
+    return -1;
+  }
+  while (fgets(buf, sizeof(buf), fp) != NULL)
+  {
+    lineno++;
+    char *p = buf + strspn(buf, " \t");
+    if (*p == '#' || *p == '\n' || *p == '\0')
+    {
+      continue;
+    }
+    name[0] = '\0';
+    n = sscanf(p, "%31s %i %15s %15s", path, &addr, model, name);
+    if (n < 3 || addr > 0x7f ||
+        (strcmp(model, "hts221") != 0 && strcmp(model, "lps25h") != 0))
+    {
+      fprintf(stderr, "%s:%d: malformed sensor\n", fname, lineno);
+      continue;
+    }
+    type = strcmp(model, "hts221") == 0 ? SENSORHTS221 : SENSORLPS25H;
+    if (n == 3)
+    {
+      snprintf(name, sizeof(name), "%.8s@%02x", model, (unsigned char)addr);
+    }
+    if (!GhSensorsAdd(path, addr, type, name))
+    {
+      fprintf(stderr, "%s:%d: too many sensors or buses\n", fname, lineno);
+    }
+  }
+  fclose(fp);
+  return nsensors;
+}
+
+/**  @brief Take one measurement from a sensor, opening it first if needed.
+ * The HTS221 calibration is read once per open, not with every sample.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param s sensor to read.
+ *   @param out receives the measurement.
+ *   @return void
+ */
+static void GhSensorsMeasure(const sensor_s *s, sensor_s *out)
+{
+  ht221sData_s h = {0};
+  lps25hData_s l = {0};
+
+  *out = *s;
+#if EMULATOR
+  // The emulator has one sensor of each model, whatever the registry says
+  h = ShGetHT221SData();
+  l = ShGetLPS25HData();
+#else
+  ht221sRaw_s hr;
+  lps25hRaw_s lr;
+
+  if (out->fd == -1)
+  {
+    out->fd = ShOpenSensor(buses[s->bus].path, s->addr,
+                           s->type == SENSORHTS221 ? HTS221WHOAMI
+                                                   : LPS25HWHOAMI);
+    out->calibrated = 0;
+  }
+  out->valid = 0;
+  out->raw = 0;
+  if (out->fd == -1)
+  {
+    return;
+  }
+  if (s->type == SENSORHTS221)
+  {
+    if (!out->calibrated && ShReadHTS221Calib(out->fd, &out->cal))
+    {
+      out->calibrated = 1;
+      out->calseq++;
+    }
+    if (!out->calibrated || !ShReadHTS221Raw(out->fd, &hr))
+    {
+      return;
+    }
+    h = ShConvertHTS221(&out->cal, hr);
+    out->tout = hr.tout;
+    out->xout = hr.hout;
+  }
+  else
+  {
+    if (!ShReadLPS25HRaw(out->fd, &lr))
+    {
+      return;
+    }
+    l = ShConvertLPS25H(lr);
+    out->tout = lr.tout;
+    out->xout = lr.pout;
+  }
+  out->raw = 1;
+#endif
+  if (s->type == SENSORHTS221)
+  {
+    out->temperature = h.temperature;
+    out->humidity = h.humidity;
+    out->valid = h.temperature == h.temperature;
+  }
+  else
+  {
+    out->temperature = l.temperature;
+    out->pressure = l.pressure;
+    out->valid = l.pressure == l.pressure;
+  }
+}
+
+/**  @brief Worker serving one bus. It reads the bus's sensors one after
+ * another for each sample, while the other buses do the same in parallel.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg the sensorbus_s served.
+ *   @return NULL
+ */
+static void *GhSensorsWorker(void *arg)
+{
+  sensorbus_s *bus = arg;
+  sensor_s result;
+  uint64_t gen;
+  unsigned types;
+  int i;
+
+  pthread_mutex_lock(&slock);
+  while (running)
+  {
+    if (bus->served == generation)
+    {
+      pthread_cond_wait(&work, &slock);
+      continue;
+    }
+    gen = generation;
+    types = wanted;
+    pthread_mutex_unlock(&slock);
+
+    for (i = 0; i < bus->nsensors; i++)
+    {
+      sensor_s *s = &sensors[bus->sensor[i]];
+      if (!(types & (1u << s->type)))
+      {
+        continue;
+      }
+      // Only this worker changes the sensor, so it can be read unlocked
+      GhSensorsMeasure(s, &result);
+      result.errors += !result.valid;
+      result.stamp = gen;
+      pthread_mutex_lock(&slock);
+      *s = result;
+      pthread_mutex_unlock(&slock);
+    }
+
+    pthread_mutex_lock(&slock);
+    bus->served = gen;
+    if (gen == generation)
+    {
+      pending--;
+      pthread_cond_signal(&done);
+    }
+  }
+  pthread_mutex_unlock(&slock);
+  return NULL;
+}
+
+/**  @brief Load the registry and start one worker per bus. Without a registry
+ * file the Sense HAT pair on I2CDEVICE is used.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname registry file name.
+ *   @return number of sensors registered.
+ */
+int GhSensorsInit(const char *fname)
+{
+  pthread_condattr_t attr;
+  int b;
+
+  if (GhSensorsParse(fname) < 0)
+  {
+    GhSensorsAdd(I2CDEVICE, HTS221I2CADDRESS, SENSORHTS221, "sensehat");
+    GhSensorsAdd(I2CDEVICE, LPS25HI2CADDRESS, SENSORLPS25H, "sensehat");
+  }
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&done, &attr);
+  pthread_condattr_destroy(&attr);
+
+  running = 1;
+  for (b = 0; b < nbuses; b++)
+  {
+    if (pthread_create(&buses[b].worker, NULL, GhSensorsWorker, &buses[b]) != 0)
+    {
+      fprintf(stderr, "%s: no worker thread, bus not polled\n", buses[b].path);
+      buses[b].nsensors = 0;
+      buses[b].served = UINT64_MAX;
+    }
+  }
+  return nsensors;
+}
+
+/**  @brief Poll every bus at once and combine the results. Temperature and
+ * humidity are the means over the HTS221 sensors and pressure the mean over
+ * the LPS25H sensors. Buses that miss SENSORTIMEOUTMS are left out.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param value receives temperature, humidity and pressure, NAN if no
+ * sensor supplied the channel.
+ *   @param types bit (1 << model) set for each sensor model to measure,
+ * SENSORALL for every sensor.
+ *   @return number of sensors that answered.
+ */
+int GhSensorsSample(double value[SENSORS], unsigned types)
+{
+  double sum[SENSORS] = {0};
+  int count[SENSORS] = {0};
+  struct timespec deadline;
+  int i, b, answered = 0;
+
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+  deadline.tv_sec += SENSORTIMEOUTMS / 1000;
+  deadline.tv_nsec += (SENSORTIMEOUTMS % 1000) * 1000000L;
+  if (deadline.tv_nsec >= 1000000000L)
+  {
+    deadline.tv_sec++;
+    deadline.tv_nsec -= 1000000000L;
+  }
+
+  pthread_mutex_lock(&slock);
+  generation++;
+  wanted = types;
+  pending = 0;
+  for (b = 0; b < nbuses; b++)
+  {
+    pending += buses[b].nsensors > 0;
+  }
+  pthread_cond_broadcast(&work);
+  while (pending > 0)
+  {
+    if (pthread_cond_timedwait(&done, &slock, &deadline) == ETIMEDOUT)
+    {
+      break;
+    }
+  }
+  for (i = 0; i < nsensors; i++)
+  {
+    const sensor_s *s = &sensors[i];
+    if (s->stamp != generation || !s->valid)
+    {
+      continue;
+    }
+    answered++;
+    if (s->type == SENSORHTS221)
+    {
+      sum[TEMPERATURE] += s->temperature;
+      sum[HUMIDITY] += s->humidity;
+      count[TEMPERATURE]++;
+      count[HUMIDITY]++;
+    }
+    else
+    {
+      sum[PRESSURE] += s->pressure;
+      count[PRESSURE]++;
+    }
+  }
+  pthread_mutex_unlock(&slock);
+
+  for (i = 0; i < SENSORS; i++)
+  {
+    value[i] = count[i] > 0 ? sum[i] / count[i] : NAN;
+  }
+  return answered;
+}
+
+/**  @brief Number of registered sensors.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return sensor count.
+ */
+int GhSensorsCount(void)
+{
+  return nsensors;
+}
+
+/**  @brief Look up a sensor for reporting. Values are stable between calls
+ * to GhSensorsSample only for buses that finished in time.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param i sensor number, 0 to GhSensorsCount() - 1.
+ *   @return the sensor, NULL if i is out of range.
+ */
+const sensor_s *GhSensorsGet(int i)
+{
+  return i >= 0 && i < nsensors ? &sensors[i] : NULL;
+}
+
+/**  @brief Append the raw counts of the last sample to the raw log, with the
+ * calibration of any HTS221 whose calibration has not been logged yet.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname raw log file name, opened on first use.
+ *   @param unit serial number stored in a new log.
+ *   @param now time of the sample.
+ *   @return 1 or 0 depending on whether the records were written.
+ */
+int GhSensorsLogRaw(const char *fname, uint64_t unit, time_t now)
+{
+  static sensor_s copy[SENSORMAX];
+  uint64_t gen;
+  int i, n;
+
+  if (!GhRawOpen(fname, unit))
+  {
+    return 0;
+  }
+  pthread_mutex_lock(&slock);
+  n = nsensors;
+  gen = generation;
+  memcpy(copy, sensors, n * sizeof(sensor_s));
+  pthread_mutex_unlock(&slock);
+
+  for (i = 0; i < n; i++)
+  {
+    const sensor_s *s = &copy[i];
+    if (s->stamp != gen || !s->valid || !s->raw)
+    {
+      continue;
+    }
+    if (s->type == SENSORHTS221)
+    {
+      if (rawcal[i] != s->calseq)
+      {
+        GhRawCalibration(i, now, &s->cal);
+        rawcal[i] = s->calseq;
+      }
+      GhRawAdd(i, RAWHTS221, now, s->tout, s->xout);
+    }
+    else
+    {
+      GhRawAdd(i, RAWLPS25H, now, s->tout, s->xout);
+    }
+  }
+  return GhRawFlush();
+}
+
+/**  @brief Stop the bus workers and close the sensors.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhSensorsClose(void)
+{
+  int b, i;
+
+  pthread_mutex_lock(&slock);
+  running = 0;
+  pthread_cond_broadcast(&work);
+  pthread_mutex_unlock(&slock);
+  for (b = 0; b < nbuses; b++)
+  {
+    if (buses[b].served != UINT64_MAX)
+    {
+      pthread_join(buses[b].worker, NULL);
+    }
+  }
+  for (i = 0; i < nsensors; i++)
+  {
+    if (sensors[i].fd != -1)
+    {
+      close(sensors[i].fd);
+      sensors[i].fd = -1;
+    }
+  }
+  GhRawClose();
+}
@@ -0,0 +1,64 @@
+/**  @brief Sensor registry constants, structures, function prototypes
+ *   @file ghsensors.h
+ */
+#ifndef GHSENSORS_H
+#define GHSENSORS_H
+#include "ghcontrol.h"
+#include "pisensehat.h"
+#include <pthread.h>
+#include <stdint.h>
+
+#define GHSENSORFILE "ghsensors.txt"
+#define SENSORMAX 64         // sensor instances in the registry
+#define SENSORBUSMAX 8       // I2C buses, each with its own worker
+#define SENSORPATHSZ 32
+#define SENSORNAMESZ 16
+#define SENSORTIMEOUTMS 1000 // longest wait for the buses to finish a sample
+#define SENSORALL ((1u << SENSORHTS221) | (1u << SENSORLPS25H))
+
+typedef enum
+{
+  SENSORHTS221,
+  SENSORLPS25H
+} sensortype_e;
+
+typedef struct sensor
+{
+  char name[SENSORNAMESZ];
+  int bus;             // index into the bus table
+  int addr;            // I2C address
+  sensortype_e type;
+  int fd;              // open handle, -1 until the sensor answers
+  uint64_t stamp;      // sample generation of the values below
+  int valid;           // set if the last measurement succeeded
+  double temperature;
+  double humidity;     // HTS221 only
+  double pressure;     // LPS25H only
+  uint64_t errors;     // failed measurements
+  int raw;             // set if tout and xout hold the measurement's counts
+  int16_t tout;        // temperature counts
+  int32_t xout;        // humidity or pressure counts
+  int calibrated;      // set once the HTS221 calibration has been read
+  uint32_t calseq;     // bumped on every calibration read
+  ht221sCalib_s cal;   // HTS221 only
+} sensor_s;
+
+typedef struct sensorbus
+{
+  char path[SENSORPATHSZ];
+  pthread_t worker;
+  uint64_t served;     // last sample generation finished
+  int nsensors;
+  int sensor[SENSORMAX];
+} sensorbus_s;
+
+///@cond INTERNAL
+int GhSensorsInit(const char *fname);
+int GhSensorsSample(double value[SENSORS], unsigned types);
+int GhSensorsCount(void);
+const sensor_s *GhSensorsGet(int i);
+int GhSensorsLogRaw(const char *fname, uint64_t unit, time_t now);
+void GhSensorsClose(void);
+///@endcond
+
+#endif
@@ -0,0 +1,160 @@
+/**  @brief Code for publishing and reading the shared memory snapshot
+ *   @file ghshm.c
+ */
+#include "ghshm.h"
+#include <fcntl.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static shmsegment_s *segment = NULL; // Shared memory map pointer
+static int writer = 0;               // Set when this process publishes
+
+/**  @brief Create the shared memory segment the controller publishes into.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name POSIX shared memory object name.
+ *   @return 1 or 0 depending on whether the segment was mapped.
+ */
+int GhShmCreate(const char *name)
+{
+  int fd;
+
+  fd = shm_open(name, O_RDWR | O_CREAT, 0644);
+  if (fd == -1)
+  {
+    perror("Error (call to 'shm_open')");
+    return 0;
+  }
+  if (ftruncate(fd, sizeof(shmsegment_s)) == -1)
+  {
+    perror("Error (call to 'ftruncate')");
+    close(fd);
+    return 0;
+  }
+  segment = mmap(NULL, sizeof(shmsegment_s), PROT_READ | PROT_WRITE,
+                 MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED)
+  {
+    segment = NULL;
+    perror("Error mmapping the shared memory");
+    return 0;
+  }
+  // Leave the sequence odd while the header is rewritten
+  atomic_store_explicit(&segment->seq, 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memset(&segment->snap, 0, sizeof(snapshot_s));
+  segment->magic = GHSHMMAGIC;
+  segment->version = GHSHMVERSION;
+  segment->size = sizeof(shmsegment_s);
+  atomic_store_explicit(&segment->seq, 2, memory_order_release);
+  writer = 1;
+  return 1;
+}
+
+/**  @brief Publish a snapshot under the seqlock. Never blocks on readers.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap snapshot to copy into shared memory.
+ *   @return void
+ */
+void GhShmPublish(const snapshot_s *snap)
+{
+  uint32_t seq;
+
+  if (segment == NULL || !writer)
+  {
+    return;
+  }
+  seq = atomic_load_explicit(&segment->seq, memory_order_relaxed);
+  atomic_store_explicit(&segment->seq, seq + 1, memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  memcpy(&segment->snap, snap, sizeof(snapshot_s));
+  atomic_store_explicit(&segment->seq, seq + 2, memory_order_release);
+}
+
+/**  @brief Map an existing snapshot segment read only.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name POSIX shared memory object name.
+ *   @return 1 if the segment exists and has a matching layout, 0 otherwise.
+ */
+int GhShmAttach(const char *name)
+{
+  int fd;
+
+  fd = shm_open(name, O_RDONLY, 0);
+  if (fd == -1)
+  {
+    return 0;
+  }
+  segment = mmap(NULL, sizeof(shmsegment_s), PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (segment == MAP_FAILED)
+  {
+    segment = NULL;
+    return 0;
+  }
+  if (segment->magic != GHSHMMAGIC || segment->version != GHSHMVERSION ||
+      segment->size != sizeof(shmsegment_s))
+  {
+    GhShmClose();
+    return 0;
+  }
+  writer = 0;
+  return 1;
+}
+
+/**  @brief Copy a consistent snapshot out of shared memory.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param snap receives the snapshot.
+ *   @return 1 on success, 0 if no consistent copy was seen within
+ * SHMREADTRIES attempts.
+ */
+int GhShmRead(snapshot_s *snap)
+{
+  uint32_t seq0, seq1;
+  int i;
+
+  if (segment == NULL)
+  {
+    return 0;
+  }
+  for (i = 0; i < SHMREADTRIES; i++)
+  {
+    seq0 = atomic_load_explicit(&segment->seq, memory_order_acquire);
+    if (seq0 & 1)
+    {
+      sched_yield();
+      continue;
+    }
+    memcpy(snap, (const void *)&segment->snap, sizeof(snapshot_s));
+    atomic_thread_fence(memory_order_acquire);
+    seq1 = atomic_load_explicit(&segment->seq, memory_order_relaxed);
+    if (seq0 == seq1)
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**  @brief Unmap the snapshot segment.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhShmClose(void)
+{
+  if (segment != NULL)
+  {
+    munmap(segment, sizeof(shmsegment_s));
+    segment = NULL;
+  }
+  writer = 0;
+}
@@ -0,0 +1,32 @@
+/**  @brief Shared memory snapshot constants, structures, function prototypes
+ *   @file ghshm.h
+ */
+#ifndef GHSHM_H
+#define GHSHM_H
+#include "ghcontrol.h"
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define GHSHMNAME "/ghcontrol"
+#define GHSHMMAGIC 0x4d534847 // "GHSM" little endian
+#define GHSHMVERSION 4
+#define SHMREADTRIES 1000
+
+typedef struct shmsegment
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t size;
+  _Atomic uint32_t seq;
+  snapshot_s snap;
+} shmsegment_s;
+
+///@cond INTERNAL
+int GhShmCreate(const char *name);
+void GhShmPublish(const snapshot_s *snap);
+int GhShmAttach(const char *name);
+int GhShmRead(snapshot_s *snap);
+void GhShmClose(void);
+///@endcond
+
+#endif
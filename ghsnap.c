@@ -0,0 +1,45 @@
+/**  @brief Print the controller snapshot published in shared memory
+ *   @file ghsnap.c
+ */
+#include "ghshm.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+int main()
+{
+  snapshot_s snap = {0};
+  uint32_t i;
+
+  if (!GhShmAttach(GHSHMNAME))
+  {
+    fprintf(stderr, "No controller snapshot at %s\n", GHSHMNAME);
+    return EXIT_FAILURE;
+  }
+  if (!GhShmRead(&snap))
+  {
+    fprintf(stderr, "Snapshot is busy\n");
+    GhShmClose();
+    return EXIT_FAILURE;
+  }
+  GhShmClose();
+
+  printf("Unit:%" PRIx64 " cycle %" PRIu64 " %s", snap.serial, snap.cycles,
+         ctime(&snap.reading.rtime));
+  printf("Readings\tT: %5.1lfC\tH: %5.1lf%%\tP: %6.1lfmb\n",
+         snap.reading.temperature, snap.reading.humidity,
+         snap.reading.pressure);
+  printf("Targets\tT: %5.1lfC\tH: %5.1lf%%\n", snap.spts.temperature,
+         snap.spts.humidity);
+  printf("Controls\tHeater: %i\tHumidifier: %i\n", snap.ctrl.heater,
+         snap.ctrl.humidifier);
+  printf("Alarms %u\n", snap.nalarms);
+  for (i = 0; i < snap.nalarms; i++)
+  {
+    time_t atime = (time_t)snap.alarms[i].atime;
+    printf("%d %.1lf %s", snap.alarms[i].code, snap.alarms[i].value,
+           ctime(&atime));
+  }
+  return EXIT_SUCCESS;
+}
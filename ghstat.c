@@ -0,0 +1,359 @@
+/**  @brief Range statistics, threshold exceedance and histograms over
+ * ghdata.txt logs, scanned through a memory map on every core
+ *   @file ghstat.c
+ */
+#include "ghcontrol.h"
+#include "ghindex.h"
+#include "ghlog.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define STATMAXTHREADS 64
+#define STATMAXBINS 256
+#define STATMAXGAP 900 // longest sample interval counted toward exceedance
+
+typedef struct fieldstats
+{
+  int64_t count;
+  int64_t sum;
+  int32_t min;
+  int32_t max;
+} fieldstats_s;
+
+typedef struct statjob
+{
+  const char *begin;
+  const char *end;
+  int64_t from;
+  int64_t to;
+  int field;
+  int32_t threshold;
+  int bins;
+  int32_t binlo;
+  int32_t binwidth;
+  int64_t records;
+  int64_t first;
+  int64_t last;
+  int lastabove; // set if the last record was above the threshold
+  fieldstats_s stats[LOGFIELDS];
+  int64_t above;
+  int64_t aboveseconds;
+  int64_t hist[STATMAXBINS + 2];
+} statjob_s;
+
+static const char *fieldnames[LOGFIELDS] = {"temperature", "humidity",
+                                            "pressure"};
+static const int fieldlo[LOGFIELDS] = {LSTEMP, LSHUMID, LSPRESS};
+static const int fieldhi[LOGFIELDS] = {USTEMP, USHUMID, USPRESS};
+
+/**  @brief Scan one newline aligned slice of the log. The interval from the
+ * last record of the previous slice to the first of this one is left to the
+ * merge.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param arg the statjob_s describing the slice and receiving its results.
+ *   @return NULL
+ */
+static void *GhStatScan(void *arg)
+{
+  statjob_s *job = arg;
+  const char *p = job->begin, *next;
+  logrecord_s rec;
+  int64_t prevtime = 0;
+  int prevabove = 0, i;
+
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    job->stats[i].min = INT32_MAX;
+    job->stats[i].max = INT32_MIN;
+  }
+  while (p < job->end)
+  {
+    next = GhLogNextLine(p, job->end);
+    if (!GhLogParseLine(p, next - p, &rec) || rec.ltime < job->from ||
+        rec.ltime >= job->to)
+    {
+      p = next;
+      continue;
+    }
+    p = next;
+    if (job->records++ == 0)
+    {
+      job->first = rec.ltime;
+    }
+    job->last = rec.ltime;
+    for (i = 0; i < LOGFIELDS; i++)
+    {
+      int32_t v = rec.value[i];
+      fieldstats_s *fs = &job->stats[i];
+      if (v == LOGMISSING)
+      {
+        continue;
+      }
+      fs->count++;
+      fs->sum += v;
+      fs->min = v < fs->min ? v : fs->min;
+      fs->max = v > fs->max ? v : fs->max;
+    }
+
+    int32_t v = rec.value[job->field];
+    if (v == LOGMISSING)
+    {
+      // Time with the sensor missing is not counted as above
+      prevabove = 0;
+      continue;
+    }
+    if (prevabove && rec.ltime > prevtime && rec.ltime - prevtime <= STATMAXGAP)
+    {
+      job->aboveseconds += rec.ltime - prevtime;
+    }
+    prevabove = v > job->threshold;
+    prevtime = rec.ltime;
+    job->above += prevabove;
+
+    int bin = v < job->binlo ? 0 : (v - job->binlo) / job->binwidth + 1;
+    job->hist[bin > job->bins ? job->bins + 1 : bin]++;
+  }
+  job->lastabove = prevabove;
+  return NULL;
+}
+
+/**  @brief Print command usage.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name program name.
+ *   @return void
+ */
+static void GhStatUsage(const char *name)
+{
+  fprintf(stderr,
+          "usage: %s [-f t|h|p] [-a threshold] [-b bins] [-s start] [-e end]\n"
+          "          [-j threads] [logfile]\n"
+          "  start and end are YYYY-MM-DD or \"YYYY-MM-DD HH:MM:SS\"\n",
+          name);
+}
+
+int main(int argc, char *argv[])
+{
+  const char *fname = GHDATAFILE;
+  int64_t from = INT64_MIN, to = INT64_MAX, lo, hi;
+  double threshold = 0;
+  int field = LOGTEMP, bins = 10, thresholdset = 0, nthreads, opt, i, j;
+  statjob_s *jobs, total = {0};
+  pthread_t tids[STATMAXTHREADS];
+  int started[STATMAXTHREADS];
+  struct stat st;
+  const char *map, *p;
+  int fd;
+
+  nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+  while ((opt = getopt(argc, argv, "f:a:b:s:e:j:")) != -1)
+  {
+    switch (opt)
+    {
+    case 'f':
+      field = optarg[0] == 'h'   ? LOGHUMID
+              : optarg[0] == 'p' ? LOGPRESS
+                                 : LOGTEMP;
+      break;
+    case 'a':
+      threshold = atof(optarg);
+      thresholdset = 1;
+      break;
+    case 'b':
+      bins = atoi(optarg);
+      break;
+    case 's':
+    case 'e':
+      if (!GhLogParseDate(optarg, opt == 's' ? &from : &to))
+      {
+        GhStatUsage(argv[0]);
+        return EXIT_FAILURE;
+      }
+      break;
+    case 'j':
+      nthreads = atoi(optarg);
+      break;
+    default:
+      GhStatUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+  if (optind < argc)
+  {
+    fname = argv[optind];
+  }
+  if (!thresholdset)
+  {
+    // The field's alarm limit unless -a gave one, in either order
+    threshold = field == LOGHUMID   ? UPPERAHUMID
+                : field == LOGPRESS ? UPPERAPRESS
+                                    : UPPERATEMP;
+  }
+  if (bins < 1 || bins > STATMAXBINS)
+  {
+    bins = 10;
+  }
+  if (nthreads < 1 || nthreads > STATMAXTHREADS)
+  {
+    nthreads = nthreads < 1 ? 1 : STATMAXTHREADS;
+  }
+
+  fd = open(fname, O_RDONLY);
+  if (fd == -1 || fstat(fd, &st) == -1)
+  {
+    perror(fname);
+    return EXIT_FAILURE;
+  }
+  if (st.st_size == 0)
+  {
+    printf("records 0\n");
+    return EXIT_SUCCESS;
+  }
+  map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED)
+  {
+    perror("Error mmapping the log");
+    return EXIT_FAILURE;
+  }
+  // Only the byte range the time index says can hold the window is scanned
+  lo = 0;
+  hi = st.st_size;
+  if ((from != INT64_MIN || to != INT64_MAX) &&
+      GhIndexRange(fname, from, to, &lo, &hi) && hi > st.st_size)
+  {
+    hi = st.st_size;
+  }
+  madvise((void *)(map + (lo & ~(int64_t)(sysconf(_SC_PAGESIZE) - 1))),
+          hi - (lo & ~(int64_t)(sysconf(_SC_PAGESIZE) - 1)),
+          MADV_SEQUENTIAL | MADV_WILLNEED);
+
+  // Split the map into newline aligned slices, one per thread
+  jobs = calloc(nthreads, sizeof(statjob_s));
+  if (jobs == NULL)
+  {
+    puts("Cannot allocate memory");
+    return EXIT_FAILURE;
+  }
+  p = map + lo;
+  for (i = 0; i < nthreads; i++)
+  {
+    const char *end = map + lo + (hi - lo) * (i + 1) / nthreads;
+    if (end < p)
+    {
+      end = p;
+    }
+    if (i < nthreads - 1 && end > map && end[-1] != '\n')
+    {
+      end = GhLogNextLine(end, map + hi);
+    }
+    jobs[i].begin = p;
+    jobs[i].end = end;
+    jobs[i].from = from;
+    jobs[i].to = to;
+    jobs[i].field = field;
+    jobs[i].threshold = (int32_t)(threshold * 10);
+    jobs[i].bins = bins;
+    jobs[i].binlo = fieldlo[field] * 10;
+    jobs[i].binwidth =
+        ((fieldhi[field] - fieldlo[field]) * 10 + bins - 1) / bins;
+    p = end;
+  }
+  for (i = 0; i < nthreads; i++)
+  {
+    started[i] = pthread_create(&tids[i], NULL, GhStatScan, &jobs[i]) == 0;
+    if (!started[i])
+    {
+      GhStatScan(&jobs[i]);
+    }
+  }
+
+  // Merge per thread results in file order
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    total.stats[i].min = INT32_MAX;
+    total.stats[i].max = INT32_MIN;
+  }
+  for (i = 0; i < nthreads; i++)
+  {
+    if (started[i])
+    {
+      pthread_join(tids[i], NULL);
+    }
+    if (jobs[i].records == 0)
+    {
+      continue;
+    }
+    if (total.records == 0)
+    {
+      total.first = jobs[i].first;
+    }
+    else if (total.lastabove && jobs[i].first > total.last &&
+             jobs[i].first - total.last <= STATMAXGAP)
+    {
+      // The interval across the slice boundary
+      total.aboveseconds += jobs[i].first - total.last;
+    }
+    total.last = jobs[i].last;
+    total.lastabove = jobs[i].lastabove;
+    total.records += jobs[i].records;
+    total.above += jobs[i].above;
+    total.aboveseconds += jobs[i].aboveseconds;
+    for (j = 0; j < LOGFIELDS; j++)
+    {
+      fieldstats_s *a = &total.stats[j], *b = &jobs[i].stats[j];
+      a->count += b->count;
+      a->sum += b->sum;
+      a->min = b->min < a->min ? b->min : a->min;
+      a->max = b->max > a->max ? b->max : a->max;
+    }
+    for (j = 0; j < bins + 2; j++)
+    {
+      total.hist[j] += jobs[i].hist[j];
+    }
+  }
+  munmap((void *)map, st.st_size);
+
+  printf("records %lld\n", (long long)total.records);
+  if (total.records == 0)
+  {
+    free(jobs);
+    return EXIT_SUCCESS;
+  }
+  printf("span %.2lf days\n", (total.last - total.first) / 86400.0);
+  printf("%-12s %8s %8s %8s\n", "field", "min", "max", "mean");
+  for (i = 0; i < LOGFIELDS; i++)
+  {
+    fieldstats_s *fs = &total.stats[i];
+    if (fs->count == 0)
+    {
+      printf("%-12s %8s %8s %8s\n", fieldnames[i], "nan", "nan", "nan");
+      continue;
+    }
+    printf("%-12s %8.1lf %8.1lf %8.1lf\n", fieldnames[i], fs->min / 10.0,
+           fs->max / 10.0, fs->sum / 10.0 / fs->count);
+  }
+  printf("%s above %.1lf: %lld records, %.2lf hours\n", fieldnames[field],
+         threshold, (long long)total.above, total.aboveseconds / 3600.0);
+  printf("%s histogram\n", fieldnames[field]);
+  printf("  %7s < %6.1lf %lld\n", "", jobs[0].binlo / 10.0,
+         (long long)total.hist[0]);
+  for (j = 1; j <= bins; j++)
+  {
+    printf("  %6.1lf .. %6.1lf %lld\n",
+           (jobs[0].binlo + (j - 1) * jobs[0].binwidth) / 10.0,
+           (jobs[0].binlo + j * jobs[0].binwidth) / 10.0,
+           (long long)total.hist[j]);
+  }
+  printf("  %7s >= %6.1lf %lld\n", "",
+         (jobs[0].binlo + bins * jobs[0].binwidth) / 10.0,
+         (long long)total.hist[bins + 1]);
+  free(jobs);
+  return EXIT_SUCCESS;
+}
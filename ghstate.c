@@ -0,0 +1,188 @@
+/**  @brief Code for the memory mapped warm restart state file
+ *   @file ghstate.c
+ */
+#include "ghstate.h"
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static int statefd = -1;            // State file handle
+static statefile_s *state = NULL;   // State file memory map pointer
+static stateslot_s *current = NULL; // Newest valid slot, NULL when cold
+
+/**  @brief Compute the FNV-1a checksum of a state slot, skipping the checksum.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param slot the slot to checksum.
+ *   @return 32 bit checksum.
+ */
+static uint32_t GhStateChecksum(const stateslot_s *slot)
+{
+  const uint8_t *p = (const uint8_t *)slot;
+  uint32_t hash = 2166136261u;
+  size_t i;
+
+  for (i = 0; i < sizeof(stateslot_s); i++)
+  {
+    if (i >= offsetof(stateslot_s, checksum) &&
+        i < offsetof(stateslot_s, checksum) + sizeof(slot->checksum))
+    {
+      continue;
+    }
+    hash = (hash ^ p[i]) * 16777619u;
+  }
+  return hash;
+}
+
+/**  @brief Map the state file into memory, creating it if needed, and find
+ * the newest slot that passes validation.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname points to the state file name.
+ *   @return 1 if a valid saved state was found, 0 for a cold start, -1 on
+ * error.
+ */
+int GhStateOpen(const char *fname)
+{
+  struct stat st;
+  int i, fresh;
+
+  statefd = open(fname, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (statefd == -1)
+  {
+    perror("Error (call to 'open')");
+    return -1;
+  }
+  if (fstat(statefd, &st) == -1)
+  {
+    perror("Error (call to 'fstat')");
+    GhStateClose();
+    return -1;
+  }
+  fresh = st.st_size != sizeof(statefile_s);
+  if (fresh && ftruncate(statefd, sizeof(statefile_s)) == -1)
+  {
+    perror("Error (call to 'ftruncate')");
+    GhStateClose();
+    return -1;
+  }
+  state = mmap(NULL, sizeof(statefile_s), PROT_READ | PROT_WRITE, MAP_SHARED,
+               statefd, 0);
+  if (state == MAP_FAILED)
+  {
+    state = NULL;
+    perror("Error mmapping the state file");
+    GhStateClose();
+    return -1;
+  }
+
+  if (fresh || state->magic != GHSTATEMAGIC ||
+      state->version != GHSTATEVERSION ||
+      state->slotsize != sizeof(stateslot_s))
+  {
+    // Unknown layout, start cold with an empty file
+    memset(state, 0, sizeof(statefile_s));
+    state->magic = GHSTATEMAGIC;
+    state->version = GHSTATEVERSION;
+    state->slotsize = sizeof(stateslot_s);
+    return 0;
+  }
+
+  current = NULL;
+  for (i = 0; i < STATESLOTS; i++)
+  {
+    stateslot_s *slot = &state->slot[i];
+    if (slot->seq == 0 || slot->nalarms > NALARMS ||
+        slot->checksum != GhStateChecksum(slot))
+    {
+      continue;
+    }
+    if (current == NULL || slot->seq > current->seq)
+    {
+      current = slot;
+    }
+  }
+  return current != NULL;
+}
+
+/**  @brief Restore the last reading, active alarm list and sensor filter state
+ * from the state file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rdata receives the last saved reading.
+ *   @param head the first element of an empty alarm linked list.
+ *   @return 1 if state was restored, 0 for a cold start.
+ */
+int GhStateRestore(reading_s *rdata, alarm_s *head)
+{
+  uint32_t i;
+
+  if (current == NULL)
+  {
+    return 0;
+  }
+  *rdata = current->lastreading;
+  for (i = 0; i < current->nalarms; i++)
+  {
+    GhSetOneAlarm((alarm_e)current->alarms[i].code,
+                  (time_t)current->alarms[i].atime, current->alarms[i].value,
+                  head);
+  }
+  GhFilterImport(current->filters);
+  return 1;
+}
+
+/**  @brief Save the current reading, alarm list and filter state into the
+ * older slot of the state file so a crash mid update leaves the previous state
+ * intact.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param rdata current sensor readings.
+ *   @param head the first element in the alarm linked list.
+ *   @return void
+ */
+void GhStateSave(reading_s rdata, alarm_s *head)
+{
+  stateslot_s *slot;
+  uint64_t seq;
+
+  if (state == NULL)
+  {
+    return;
+  }
+  seq = current == NULL ? 1 : current->seq + 1;
+  slot = &state->slot[seq % STATESLOTS];
+
+  memset(slot, 0, sizeof(stateslot_s));
+  slot->lastreading = rdata;
+  slot->nalarms = GhAlarmRecords(head, slot->alarms, NALARMS);
+  GhFilterExport(slot->filters);
+  slot->seq = seq;
+  slot->checksum = GhStateChecksum(slot);
+  current = slot;
+}
+
+/**  @brief Flush and unmap the state file.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhStateClose(void)
+{
+  if (state != NULL)
+  {
+    msync(state, sizeof(statefile_s), MS_SYNC);
+    munmap(state, sizeof(statefile_s));
+    state = NULL;
+  }
+  current = NULL;
+  if (statefd != -1)
+  {
+    close(statefd);
+    statefd = -1;
+  }
+}
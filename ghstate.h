@@ -0,0 +1,41 @@
+/**  @brief Warm restart state file constants, structures, function prototypes
+ *   @file ghstate.h
+ */
+#ifndef GHSTATE_H
+#define GHSTATE_H
+#include "ghcontrol.h"
+#include "ghfilter.h"
+#include <stdint.h>
+
+#define GHSTATEFILE "ghstate.dat"
+#define GHSTATEMAGIC 0x54534847 // "GHST" little endian
+#define GHSTATEVERSION 5
+#define STATESLOTS 2
+
+typedef struct stateslot
+{
+  uint64_t seq;
+  uint32_t checksum;
+  uint32_t nalarms;
+  reading_s lastreading;
+  alarmrecord_s alarms[NALARMS];
+  filterstate_s filters[FILTERSENSORS];
+} stateslot_s;
+
+typedef struct statefile
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t slotsize;
+  uint32_t reserved;
+  stateslot_s slot[STATESLOTS];
+} statefile_s;
+
+///@cond INTERNAL
+int GhStateOpen(const char *fname);
+int GhStateRestore(reading_s *rdata, alarm_s *head);
+void GhStateSave(reading_s rdata, alarm_s *head);
+void GhStateClose(void);
+///@endcond
+
+#endif
@@ -0,0 +1,211 @@
+/**  @brief Code for the always on trace recorder. Each thread writes begin
+ * and end events into its own ring without locks, and the rings are dumped
+ * as Chrome trace JSON on request or after a slow cycle
+ *   @file ghtrace.c
+ */
+#define _GNU_SOURCE
+#include "ghtrace.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+static tracering_s rings[TRACETHREADS];       // One ring per recording thread
+static _Atomic int nrings = 0;                // Rings handed out
+static _Thread_local tracering_s *myring;     // Ring of the calling thread
+static _Thread_local int noring;              // Set if no ring was left
+static volatile sig_atomic_t dumprequest = 0; // Set by SIGUSR1
+static traceevent_s copy[TRACERING];          // Dump scratch copy of one ring
+static char buf[TRACEBUFSZ];                  // Dump output buffer
+
+/**  @brief Note a dump request from SIGUSR1.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param sig signal number.
+ *   @return void
+ */
+static void GhTraceSignal(int sig)
+{
+  (void)sig;
+  dumprequest = 1;
+}
+
+/**  @brief Install the SIGUSR1 handler that requests a trace dump.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return void
+ */
+void GhTraceInit(void)
+{
+  struct sigaction sa;
+
+  memset(&sa, 0, sizeof(sa));
+  sa.sa_handler = GhTraceSignal;
+  sigemptyset(&sa.sa_mask);
+  sa.sa_flags = SA_RESTART;
+  sigaction(SIGUSR1, &sa, NULL);
+}
+
+/**  @brief Append one event to the calling thread's ring, claiming a ring on
+ * the thread's first event.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name static span name.
+ *   @param arg value shown with the event.
+ *   @param phase 'B' or 'E'.
+ *   @return void
+ */
+static void GhTraceRecord(const char *name, int32_t arg, char phase)
+{
+  struct timespec ts;
+  traceevent_s *ev;
+  uint64_t head;
+  int i;
+
+  if (myring == NULL)
+  {
+    if (noring)
+    {
+      return;
+    }
+    i = atomic_fetch_add(&nrings, 1);
+    if (i >= TRACETHREADS)
+    {
+      noring = 1;
+      return;
+    }
+    myring = &rings[i];
+    myring->tid = (uint32_t)gettid();
+  }
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  head = atomic_load_explicit(&myring->head, memory_order_relaxed);
+  ev = &myring->ev[head & (TRACERING - 1)];
+  ev->ns = (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+  ev->name = name;
+  ev->arg = arg;
+  ev->phase = phase;
+  atomic_store_explicit(&myring->head, head + 1, memory_order_release);
+}
+
+/**  @brief Mark the start of a span on the calling thread.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name static span name.
+ *   @param arg value shown with the span, for example a register.
+ *   @return void
+ */
+void GhTraceBegin(const char *name, int32_t arg)
+{
+  GhTraceRecord(name, arg, 'B');
+}
+
+/**  @brief Mark the end of a span on the calling thread.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param name static span name, the same as its begin.
+ *   @return void
+ */
+void GhTraceEnd(const char *name)
+{
+  GhTraceRecord(name, 0, 'E');
+}
+
+/**  @brief Check for and clear a SIGUSR1 dump request.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @return 1 if a dump was requested.
+ */
+int GhTraceRequested(void)
+{
+  if (!dumprequest)
+  {
+    return 0;
+  }
+  dumprequest = 0;
+  return 1;
+}
+
+/**  @brief Write buffered output once it is nearly full.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fd output file.
+ *   @param len buffered length, reset after writing.
+ *   @param force write even if the buffer has room.
+ *   @return 1 or 0 depending on whether the write succeeded.
+ */
+static int GhTraceFlush(int fd, size_t *len, int force)
+{
+  if (*len == 0 || (!force && *len < TRACEBUFSZ - 256))
+  {
+    return 1;
+  }
+  if (write(fd, buf, *len) != (ssize_t)*len)
+  {
+    return 0;
+  }
+  *len = 0;
+  return 1;
+}
+
+/**  @brief Dump every ring as Chrome trace JSON, loadable in chrome://tracing
+ * and Perfetto. Rings keep recording during the dump, events overwritten
+ * while a ring is copied are left out.
+ *   @version 19OCT2026
+ *   @author Caio Cotts
+ *   @param fname output file, replaced through a temporary file.
+ *   @return number of events written, -1 on error.
+ */
+int GhTraceDump(const char *fname)
+{
+  char tmpname[256];
+  uint64_t head, base, first, again, j;
+  size_t len = 0;
+  int fd, i, n, total = 0, ok = 1;
+
+  snprintf(tmpname, sizeof(tmpname), "%s.tmp", fname);
+  fd = open(tmpname, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd == -1)
+  {
+    return -1;
+  }
+  len = snprintf(buf, sizeof(buf),
+                 "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  n = atomic_load(&nrings);
+  for (i = 0; i < n && i < TRACETHREADS && ok; i++)
+  {
+    tracering_s *r = &rings[i];
+    head = atomic_load_explicit(&r->head, memory_order_acquire);
+    base = head > TRACERING ? head - TRACERING : 0;
+    for (j = base; j < head; j++)
+    {
+      copy[j - base] = r->ev[j & (TRACERING - 1)];
+    }
+    // Slots the writer reached while they were copied hold newer events
+    again = atomic_load_explicit(&r->head, memory_order_acquire);
+    first = again >= TRACERING && again - TRACERING + 1 > base
+                ? again - TRACERING + 1
+                : base;
+    for (j = first; j < head && ok; j++)
+    {
+      const traceevent_s *ev = &copy[j - base];
+      len += snprintf(buf + len, sizeof(buf) - len,
+                      "%s\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%llu.%03u,"
+                      "\"pid\":1,\"tid\":%u,\"args\":{\"v\":%d}}",
+                      total ? "," : "", ev->name, ev->phase,
+                      (unsigned long long)(ev->ns / 1000),
+                      (unsigned)(ev->ns % 1000), r->tid, ev->arg);
+      total++;
+      ok = GhTraceFlush(fd, &len, 0);
+    }
+  }
+  len += snprintf(buf + len, sizeof(buf) - len, "\n]}\n");
+  ok = ok && GhTraceFlush(fd, &len, 1);
+  if (close(fd) != 0 || !ok || rename(tmpname, fname) != 0)
+  {
+    unlink(tmpname);
+    return -1;
+  }
+  return total;
+}
@@ -0,0 +1,39 @@
+/**  @brief Trace recorder constants, structures, function prototypes
+ *   @file ghtrace.h
+ */
+#ifndef GHTRACE_H
+#define GHTRACE_H
+#include <stdatomic.h>
+#include <stdint.h>
+
+#define GHTRACEFILE "ghtrace.json"
+#define TRACERING 2048          // events kept per thread, a power of two
+#define TRACETHREADS 16         // threads that can record, bus workers included
+#define TRACEDEADLINEUS 100000  // cycle time that triggers a dump
+#define TRACEDUMPGAP 60         // seconds between overrun triggered dumps
+#define TRACEBUFSZ 8192
+
+typedef struct traceevent
+{
+  uint64_t ns;      // CLOCK_MONOTONIC nanoseconds
+  const char *name; // static string naming the span
+  int32_t arg;      // optional value shown with the event
+  char phase;       // 'B' begin, 'E' end
+} traceevent_s;
+
+typedef struct tracering
+{
+  _Atomic uint64_t head; // events ever written, the next slot is head % size
+  uint32_t tid;          // kernel thread id
+  traceevent_s ev[TRACERING];
+} tracering_s;
+
+///@cond INTERNAL
+void GhTraceInit(void);
+void GhTraceBegin(const char *name, int32_t arg);
+void GhTraceEnd(const char *name);
+int GhTraceRequested(void);
+int GhTraceDump(const char *fname);
+///@endcond
+
+#endif
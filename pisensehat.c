@@ -4,69 +4,295 @@
  */
 
 #include "pisensehat.h"
+#include "ghtrace.h"
 
-static int fbfd;      // Frame buffer file handle;
-static uint16_t *map; // Frame buffer memory map pointer;
-static int HTS221fd;  // HTS221 Sensor file handle;
-static int LPS25Hfd;  // LPS25Hfd Sensor file handle;
+static int fbfd = -1;      // Frame buffer file handle;
+static uint16_t *map;      // Frame buffer memory map pointer;
+static int HTS221fd = -1;  // HTS221 Sensor file handle;
+static int LPS25Hfd = -1;  // LPS25Hfd Sensor file handle;
+static int joystickfd = -1; // Joystick event device handle;
 int numReadings = 0;  // python threads maximum reached after about a dozen readings
 
-/** @brief Initialize Sensehat
- *  @author Paul Moggach
- *  @author Kristian Medri 
- *  @version 2020-05-01
- *  @param void
- *  @return exit status
+static _Atomic int devstate[SHDEVICES]; // shstate_e of each device
+static pthread_mutex_t shlock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t shcond = PTHREAD_COND_INITIALIZER;
+
+#if !EMULATOR
+/** @brief Read one sensor register, traced
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param fd sensor file handle
+ *  @param reg register to read
+ *  @return register value, -1 on a bus error
  */
-int ShInit(void)
+static int ShI2CRead(int fd, int reg)
+{
+    int v;
+
+    GhTraceBegin("i2c read", reg);
+    v = wiringPiI2CReadReg8(fd, reg);
+    GhTraceEnd("i2c read");
+    return v;
+}
+
+/** @brief Write one sensor register, traced
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param fd sensor file handle
+ *  @param reg register to write
+ *  @param data value to write
+ *  @return wiringPi status
+ */
+static int ShI2CWrite(int fd, int reg, int data)
+{
+    int v;
+
+    GhTraceBegin("i2c write", reg);
+    v = wiringPiI2CWriteReg8(fd, reg, data);
+    GhTraceEnd("i2c write");
+    return v;
+}
+
+#endif
+
+/** @brief Record the outcome of a device probe and wake anyone waiting on it
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param dev device probed
+ *  @param present 1 if the device was found
+ *  @return void
+ */
+static void ShProbeDone(shdevice_e dev, int present)
+{
+    pthread_mutex_lock(&shlock);
+    atomic_store(&devstate[dev], present ? SHPRESENT : SHABSENT);
+    pthread_cond_broadcast(&shcond);
+    pthread_mutex_unlock(&shlock);
+}
+
+#if !EMULATOR
+/** @brief Map the 8X8 LED matrix frame buffer
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @return 1 if the matrix is usable
+ */
+static int ShProbeMatrix(void)
 {
-#if EMULATOR
-    Py_Initialize();
-#else
-    wiringPiSetup();
     struct fb_fix_screeninfo fix_info;
 
-    // Frame Buffer Initialization for 8X8 LED Matrix
     /* open the led frame buffer device */
-    fbfd = open(FILEPATH, O_RDWR);
+    fbfd = open(FILEPATH, O_RDWR | O_CLOEXEC);
     if (fbfd == -1)
     {
-        perror("Error (call to 'open')");
-        exit(EXIT_FAILURE);
+        return 0;
     }
 
-    /* read fixed screen info for the open device */
-    if (ioctl(fbfd, FBIOGET_FSCREENINFO, &fix_info) == -1)
+    /* read fixed screen info and check the correct device has been found */
+    if (ioctl(fbfd, FBIOGET_FSCREENINFO, &fix_info) == -1 ||
+        strcmp(fix_info.id, "RPi-Sense FB") != 0)
     {
-        perror("Error (call to 'ioctl')");
         close(fbfd);
-        exit(EXIT_FAILURE);
-    }
-
-    /* now check the correct device has been found */
-    if (strcmp(fix_info.id, "RPi-Sense FB") != 0)
-    {
-        printf("%s\n", "Error: RPi-Sense FB not found");
-        close(fbfd);
-        exit(EXIT_FAILURE);
+        fbfd = -1;
+        return 0;
     }
 
     /* map the led frame buffer device into memory */
     map = mmap(NULL, FILESIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fbfd, 0);
     if (map == MAP_FAILED)
     {
+        map = NULL;
         close(fbfd);
-        perror("Error mmapping the file");
-        exit(EXIT_FAILURE);
+        fbfd = -1;
+        return 0;
     }
+    return 1;
+}
+
+/** @brief Open one I2C sensor and check it answers with its identity
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param bus I2C bus device, for example "/dev/i2c-1"
+ *  @param addr I2C address of the sensor
+ *  @param whoami value the WHO_AM_I register must hold
+ *  @return the sensor file handle, -1 if the sensor is missing
+ */
+int ShOpenSensor(const char *bus, int addr, int whoami)
+{
+    int fd;
 
-    // Sensor Initialization
-    HTS221fd = wiringPiI2CSetup(HTS221I2CADDRESS);
-    LPS25Hfd = wiringPiI2CSetup(LPS25HI2CADDRESS);
+    // Opened directly rather than with wiringPiI2CSetup, which exits the
+    // program when the bus is missing
+    fd = open(bus, O_RDWR | O_CLOEXEC);
+    if (fd == -1)
+    {
+        return -1;
+    }
+    if (ioctl(fd, I2CSLAVE, addr) == -1 ||
+        ShI2CRead(fd, WHO_AM_I) != whoami)
+    {
+        close(fd);
+        return -1;
+    }
 
     // Power down the device (clean start)
-    wiringPiI2CWriteReg8(HTS221fd, CTRL_REG1, 0x00);
-    wiringPiI2CWriteReg8(LPS25Hfd, CTRL_REG1, 0x00);
+    ShI2CWrite(fd, CTRL_REG1, 0x00);
+    return fd;
+}
+
+/** @brief Find the joystick among the input event devices
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @return 1 if the joystick was found
+ */
+static int ShProbeJoystick(void)
+{
+    char path[64], name[64];
+    struct dirent *de;
+    DIR *dir;
+    int fd;
+
+    dir = opendir(JOYSTICKDIR);
+    if (dir == NULL)
+    {
+        return 0;
+    }
+    while ((de = readdir(dir)) != NULL)
+    {
+        if (strncmp(de->d_name, "event", 5) != 0)
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", JOYSTICKDIR, de->d_name);
+        fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+        if (fd == -1)
+        {
+            continue;
+        }
+        if (ioctl(fd, EVIOCGNAME(sizeof(name)), name) > 0 &&
+            strcmp(name, JOYSTICKNAME) == 0)
+        {
+            joystickfd = fd;
+            break;
+        }
+        close(fd);
+    }
+    closedir(dir);
+    return joystickfd != -1;
+}
+
+#endif
+
+/** @brief Thread probing one device
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param arg the shdevice_e to probe
+ *  @return NULL
+ */
+static void *ShProbeThread(void *arg)
+{
+    shdevice_e dev = (shdevice_e)(intptr_t)arg;
+
+#if EMULATOR
+    // The emulator provides every device
+    ShProbeDone(dev, 1);
+#else
+    switch (dev)
+    {
+    case SHMATRIX:
+        ShProbeDone(dev, ShProbeMatrix());
+        break;
+    case SHHTS221:
+        HTS221fd = ShOpenSensor(I2CDEVICE, HTS221I2CADDRESS, HTS221WHOAMI);
+        ShProbeDone(dev, HTS221fd != -1);
+        break;
+    case SHLPS25H:
+        LPS25Hfd = ShOpenSensor(I2CDEVICE, LPS25HI2CADDRESS, LPS25HWHOAMI);
+        ShProbeDone(dev, LPS25Hfd != -1);
+        break;
+    default:
+        ShProbeDone(dev, ShProbeJoystick());
+        break;
+    }
+#endif
+    return NULL;
+}
+
+/** @brief Start probing a device in the background unless already started
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param dev device to probe
+ *  @return 1 if a probe was started by this call
+ */
+int ShProbe(shdevice_e dev)
+{
+    pthread_attr_t attr;
+    pthread_t tid;
+    int expected = SHUNPROBED;
+
+    if (!atomic_compare_exchange_strong(&devstate[dev], &expected, SHPROBING))
+    {
+        return 0;
+    }
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&tid, &attr, ShProbeThread, (void *)(intptr_t)dev) != 0)
+    {
+        // No thread to spare, probe inline
+        ShProbeThread((void *)(intptr_t)dev);
+    }
+    pthread_attr_destroy(&attr);
+    return 1;
+}
+
+/** @brief State of a device, starting its probe on first use
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param dev device to look at
+ *  @return shstate_e of the device, without waiting for a running probe
+ */
+shstate_e ShState(shdevice_e dev)
+{
+    ShProbe(dev);
+    return (shstate_e)atomic_load(&devstate[dev]);
+}
+
+/** @brief Wait for the probe of a device to finish
+ *  @author Caio Cotts
+ *  @version 2026-10-19
+ *  @param dev device to wait for
+ *  @return 1 if the device is present
+ */
+int ShWait(shdevice_e dev)
+{
+    if (ShState(dev) == SHPROBING)
+    {
+        pthread_mutex_lock(&shlock);
+        while (atomic_load(&devstate[dev]) == SHPROBING)
+        {
+            pthread_cond_wait(&shcond, &shlock);
+        }
+        pthread_mutex_unlock(&shlock);
+    }
+    return atomic_load(&devstate[dev]) == SHPRESENT;
+}
+
+/** @brief Initialize Sensehat. The matrix and joystick are probed on their
+ *  own threads and this returns at once; missing devices are left out rather
+ *  than fatal. The sensors are probed on first use, since controllers with a
+ *  sensor registry reach them through their own bus workers instead
+ *  @author Paul Moggach
+ *  @author Kristian Medri 
+ *  @version 2026-10-19
+ *  @param void
+ *  @return exit status
+ */
+int ShInit(void)
+{
+#if EMULATOR
+    Py_Initialize();
+#else
+    ShProbe(SHMATRIX);
+    ShProbe(SHJOYSTICK);
 #endif
     return EXIT_SUCCESS;
 }
@@ -83,16 +309,35 @@ int ShExit(void)
 #if EMULATOR
     Py_Finalize();
 #else
-    ShClearMatrix();
-    /* un-map and close */
-    if (munmap(map, FILESIZE) == -1)
+    int dev;
+
+    for (dev = 0; dev < SHDEVICES; dev++)
+    {
+        ShWait(dev);
+    }
+    if (map != NULL)
+    {
+        ShClearMatrix();
+        /* un-map and close */
+        if (munmap(map, FILESIZE) == -1)
+        {
+            perror("Error un-mmapping the file");
+            return EXIT_FAILURE;
+        }
+        close(fbfd);
+    }
+    if (HTS221fd != -1)
     {
-        perror("Error un-mmapping the file");
-        return EXIT_FAILURE;
+        close(HTS221fd);
+    }
+    if (LPS25Hfd != -1)
+    {
+        close(LPS25Hfd);
+    }
+    if (joystickfd != -1)
+    {
+        close(joystickfd);
     }
-    close(fbfd);
-    close(HTS221fd);
-    close(LPS25Hfd);
 #endif
     return EXIT_SUCCESS;
 }
@@ -130,7 +375,11 @@ void ShClearMatrix(void)
         "sense=SenseHat()\n"
         "sense.clear()\n");
 #else
-    memset(map, 0, FILESIZE);
+    // Headless units have no matrix, drawing is skipped
+    if (ShState(SHMATRIX) == SHPRESENT)
+    {
+        memset(map, 0, FILESIZE);
+    }
 #endif
 }
 
@@ -157,7 +406,7 @@ uint8_t ShSetPixel(int x, int y, fbpixel_s px)
 #else
     int i;
 
-    if (x >= 0 && x < 8 && y >= 0 && y < 8)
+    if (x >= 0 && x < 8 && y >= 0 && y < 8 && ShState(SHMATRIX) == SHPRESENT)
     {
         i = (y * 8) + x; // offset into array
         map[i] = (px.red << 11) | (px.green << 5) | (px.blue);
@@ -201,76 +450,310 @@ int ShSetVerticalBar(int bar, fbpixel_s px, uint8_t value)
     return EXIT_FAILURE;
 }
 
-/** @brief Gets LPS25H Sensehat sensor information
+#if !EMULATOR
+/** @brief Take one raw pressure and temperature measurement from an LPS25H
  *  @author Paul Moggach
  *  @author Kristian Medri
- *  @version 2020-05-01
- *  @param void
- *  @return lps25hData_s pressure and temperature data
+ *  @version 2026-10-19
+ *  @param fd sensor file handle from ShOpenSensor
+ *  @param raw receives the output registers
+ *  @return 1 on success, 0 on a bus error
  */
-lps25hData_s ShGetLPS25HData(void)
+int ShReadLPS25HRaw(int fd, lps25hRaw_s *raw)
 {
-    lps25hData_s rd = {0};
-#if EMULATOR
-    PyRun_SimpleString(
-        "from sense_emu import SenseHat\n"
-        "sense=SenseHat()\n"
-        "temp=sense.pressure\n"
-        "f=open(\"tempfileforpython.txt\",\"w\")\n"
-        "f.write(repr(temp))\n"
-        "f.close()\n");
-    double reading = 0;
-    FILE *fp;
-    fp = fopen("tempfileforpython.txt", "r");
-    fscanf(fp, "%lf", &reading);
-    fclose(fp);
-    rd.pressure = reading;
-    rd.temperature = 5; //placeholder, use the temperature from the ht221s
-#else
     uint8_t temp_out_l = 0, temp_out_h = 0;
-    int16_t temp_out = 0;
     uint8_t press_out_xl = 0;
     uint8_t press_out_l = 0;
     uint8_t press_out_h = 0;
-    int32_t press_out = 0;
-    uint8_t status = 0;
+    int status = 0;
 
     // Power down the device (clean start)
-    wiringPiI2CWriteReg8(LPS25Hfd, CTRL_REG1, 0x00);
+    ShI2CWrite(fd, CTRL_REG1, 0x00);
 
     // Turn on the humidity sensor analog front end in single shot mode
-    wiringPiI2CWriteReg8(LPS25Hfd, CTRL_REG1, 0x84);
+    ShI2CWrite(fd, CTRL_REG1, 0x84);
 
     // Run one-shot measurement (temperature and humidity). The set bit will be reset by the
     // sensor itself after execution (self-clearing bit)
-    wiringPiI2CWriteReg8(LPS25Hfd, CTRL_REG2, 0x01);
+    ShI2CWrite(fd, CTRL_REG2, 0x01);
 
     // Wait until the measurement is completed
     do
     {
         usleep(HTS221DELAY); // 25 ms
-        status = wiringPiI2CReadReg8(LPS25Hfd, CTRL_REG2);
-    } while (status != 0);
+        status = ShI2CRead(fd, CTRL_REG2);
+    } while (status > 0);
+    if (status < 0)
+    {
+        // Bus error, the sensor stopped answering
+        return 0;
+    }
 
     /* Read the temperature measurement (2 bytes to read) */
-    temp_out_l = wiringPiI2CReadReg8(LPS25Hfd, TEMP_OUT_L);
-    temp_out_h = wiringPiI2CReadReg8(LPS25Hfd, TEMP_OUT_H);
+    temp_out_l = ShI2CRead(fd, TEMP_OUT_L);
+    temp_out_h = ShI2CRead(fd, TEMP_OUT_H);
 
     /* Read the pressure measurement (3 bytes to read) */
-    press_out_xl = wiringPiI2CReadReg8(LPS25Hfd, PRESS_OUT_XL);
-    press_out_l = wiringPiI2CReadReg8(LPS25Hfd, PRESS_OUT_L);
-    press_out_h = wiringPiI2CReadReg8(LPS25Hfd, PRESS_OUT_H);
+    press_out_xl = ShI2CRead(fd, PRESS_OUT_XL);
+    press_out_l = ShI2CRead(fd, PRESS_OUT_L);
+    press_out_h = ShI2CRead(fd, PRESS_OUT_H);
 
     /* make 16 and 24 bit values (using bit shift) */
-    temp_out = temp_out_h << 8 | temp_out_l;
-    press_out = press_out_h << 16 | press_out_l << 8 | press_out_xl;
+    raw->tout = temp_out_h << 8 | temp_out_l;
+    raw->pout = press_out_h << 16 | press_out_l << 8 | press_out_xl;
+
+    // Power down the device
+    ShI2CWrite(fd, CTRL_REG1, 0x00);
+    return 1;
+}
+
+/** @brief Convert a raw LPS25H measurement to degrees and millibars
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param raw output registers from ShReadLPS25HRaw
+ *  @return lps25hData_s pressure and temperature data
+ */
+lps25hData_s ShConvertLPS25H(lps25hRaw_s raw)
+{
+    lps25hData_s rd = {0};
 
     /* calculate output values */
-    rd.temperature = 42.5 + (temp_out / 480.0);
-    rd.pressure = press_out / 4096.0;
+    rd.temperature = 42.5 + (raw.tout / 480.0);
+    rd.pressure = raw.pout / 4096.0;
+    return rd;
+}
+
+/** @brief Take one pressure and temperature measurement from an LPS25H
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param fd sensor file handle from ShOpenSensor
+ *  @return lps25hData_s pressure and temperature data, NAN on a bus error
+ */
+lps25hData_s ShReadLPS25H(int fd)
+{
+    lps25hData_s rd = {0};
+    lps25hRaw_s raw;
+
+    if (!ShReadLPS25HRaw(fd, &raw))
+    {
+        rd.temperature = rd.pressure = NAN;
+        return rd;
+    }
+    return ShConvertLPS25H(raw);
+}
+
+/** @brief Read the factory calibration of an HTS221. It never changes, so
+ *  callers that keep the sensor open read it once
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param fd sensor file handle from ShOpenSensor
+ *  @param cal receives the calibration registers
+ *  @return 1 on success, 0 on a bus error
+ */
+int ShReadHTS221Calib(int fd, ht221sCalib_s *cal)
+{
+    int t0_out_l, t0_out_h, t1_out_l, t1_out_h;
+    int t0_degC_x8, t1_degC_x8, t1_t0_msb;
+    int h0_out_l, h0_out_h, h1_out_l, h1_out_h, h0_rh_x2, h1_rh_x2;
+
+    // Read calibration temperature LSB (ADC) data
+    // (temperature calibration x-data for two points)
+    t0_out_l = ShI2CRead(fd, T0_OUT_L);
+    t0_out_h = ShI2CRead(fd, T0_OUT_H);
+    t1_out_l = ShI2CRead(fd, T1_OUT_L);
+    t1_out_h = ShI2CRead(fd, T1_OUT_H);
+
+    // Read calibration relative humidity LSB (ADC) data
+    // (humidity calibration x-data for two points)
+    h0_out_l = ShI2CRead(fd, H0_T0_OUT_L);
+    h0_out_h = ShI2CRead(fd, H0_T0_OUT_H);
+    h1_out_l = ShI2CRead(fd, H1_T0_OUT_L);
+    h1_out_h = ShI2CRead(fd, H1_T0_OUT_H);
+
+    // Read calibration temperature (�C) data
+    // (temperature calibration y-data for two points)
+    t0_degC_x8 = ShI2CRead(fd, T0_degC_x8);
+    t1_degC_x8 = ShI2CRead(fd, T1_degC_x8);
+    t1_t0_msb = ShI2CRead(fd, T1_T0_MSB);
+
+    // Read relative humidity (% rH) data
+    // (humidity calibration y-data for two points)
+    h0_rh_x2 = ShI2CRead(fd, H0_rH_x2);
+    h1_rh_x2 = ShI2CRead(fd, H1_rH_x2);
+    if ((t0_out_l | t0_out_h | t1_out_l | t1_out_h | h0_out_l | h0_out_h |
+         h1_out_l | h1_out_h | t0_degC_x8 | t1_degC_x8 | t1_t0_msb | h0_rh_x2 |
+         h1_rh_x2) < 0)
+    {
+        // Bus error, the sensor stopped answering
+        return 0;
+    }
+
+    // make 16 bit values (bit shift)
+    // (temperature calibration x-values)
+    cal->t0out = t0_out_h << 8 | t0_out_l;
+    cal->t1out = t1_out_h << 8 | t1_out_l;
+
+    // make 16 and 10 bit values (bit mask and bit shift)
+    cal->t0degcx8 = (t1_t0_msb & 3) << 8 | t0_degC_x8;
+    cal->t1degcx8 = ((t1_t0_msb & 12) >> 2) << 8 | t1_degC_x8;
+
+    // make 16 bit values (bit shift)
+    // (humidity calibration x-values)
+    cal->h0out = h0_out_h << 8 | h0_out_l;
+    cal->h1out = h1_out_h << 8 | h1_out_l;
+    cal->h0rhx2 = h0_rh_x2;
+    cal->h1rhx2 = h1_rh_x2;
+    return 1;
+}
+
+/** @brief Take one raw temperature and humidity measurement from an HTS221
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param fd sensor file handle from ShOpenSensor
+ *  @param raw receives the output registers
+ *  @return 1 on success, 0 on a bus error
+ */
+int ShReadHTS221Raw(int fd, ht221sRaw_s *raw)
+{
+    int status;
+    uint8_t t_out_l, t_out_h;
+    uint8_t h_t_out_l, h_t_out_h;
+
+    // Power down the device (clean start)
+    ShI2CWrite(fd, CTRL_REG1, 0x00);
+    // Turn on the humidity sensor analog front end in single shot mode
+    ShI2CWrite(fd, CTRL_REG1, 0x84);
+    // Run one-shot measurement (temperature and humidity). The set bit will be reset by the
+    // sensor itself after execution (self-clearing bit)
+    ShI2CWrite(fd, CTRL_REG2, 0x01);
+
+    // Wait until the measurement is completed
+    do
+    {
+        usleep(HTS221DELAY); // 25 ms
+        status = ShI2CRead(fd, CTRL_REG2);
+    } while (status > 0);
+    if (status < 0)
+    {
+        // Bus error, the sensor stopped answering
+        return 0;
+    }
+
+    // Read the ambient temperature measurement (2 bytes to read)
+    t_out_l = ShI2CRead(fd, TEMP_OUT_L);
+    t_out_h = ShI2CRead(fd, TEMP_OUT_H);
+
+    // Read the ambient humidity measurement (2 bytes to read)
+    h_t_out_l = ShI2CRead(fd, H_T_OUT_L);
+    h_t_out_h = ShI2CRead(fd, H_T_OUT_H);
+
+    // make 16 bit values
+    raw->tout = t_out_h << 8 | t_out_l;
+    raw->hout = h_t_out_h << 8 | h_t_out_l;
 
     // Power down the device
-    wiringPiI2CWriteReg8(LPS25Hfd, CTRL_REG1, 0x00);
+    ShI2CWrite(fd, CTRL_REG1, 0x00);
+    return 1;
+}
+
+/** @brief Convert a raw HTS221 measurement to degrees and percent
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param cal calibration from ShReadHTS221Calib
+ *  @param raw output registers from ShReadHTS221Raw
+ *  @return ht221sData_s temperature and humidity data
+ */
+ht221sData_s ShConvertHTS221(const ht221sCalib_s *cal, ht221sRaw_s raw)
+{
+    ht221sData_s rd = {0};
+    double T0_DegC, T1_DegC;
+    double t_gradient_m, t_intercept_c;
+    double H0_rH, H1_rH, h_gradient_m, h_intercept_c;
+
+    // Calculate calibration values
+    // (temperature calibration y-values)
+    T0_DegC = cal->t0degcx8 / 8.0;
+    T1_DegC = cal->t1degcx8 / 8.0;
+
+    // Solve the linear equasions 'y = mx + c' to give the
+    // calibration straight line graphs for temperature and humidity
+    t_gradient_m = (T1_DegC - T0_DegC) / (cal->t1out - cal->t0out);
+    t_intercept_c = T1_DegC - (t_gradient_m * cal->t1out);
+
+    // Humidity calibration values
+    // (humidity calibration y-values)
+    H0_rH = cal->h0rhx2 / 2.0;
+    H1_rH = cal->h1rhx2 / 2.0;
+    h_gradient_m = (H1_rH - H0_rH) / (cal->h1out - cal->h0out);
+    h_intercept_c = H1_rH - (h_gradient_m * cal->h1out);
+
+    // Calculate and return ambient temperature
+    rd.temperature = (t_gradient_m * raw.tout) + t_intercept_c;
+    rd.humidity = (h_gradient_m * raw.hout) + h_intercept_c;
+    return rd;
+}
+
+/** @brief Take one temperature and humidity measurement from an HTS221
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2026-10-19
+ *  @param fd sensor file handle from ShOpenSensor
+ *  @return ht221sData_s temperature and humidity data, NAN on a bus error
+ */
+ht221sData_s ShReadHTS221(int fd)
+{
+    ht221sData_s rd = {0};
+    ht221sCalib_s cal;
+    ht221sRaw_s raw;
+
+    if (!ShReadHTS221Raw(fd, &raw) || !ShReadHTS221Calib(fd, &cal))
+    {
+        rd.temperature = rd.humidity = NAN;
+        return rd;
+    }
+    return ShConvertHTS221(&cal, raw);
+}
+#endif
+
+/** @brief Gets LPS25H Sensehat sensor information
+ *  @author Paul Moggach
+ *  @author Kristian Medri
+ *  @version 2020-05-01
+ *  @param void
+ *  @return lps25hData_s pressure and temperature data
+ */
+lps25hData_s ShGetLPS25HData(void)
+{
+    lps25hData_s rd = {0};
+#if EMULATOR
+    PyRun_SimpleString(
+        "from sense_emu import SenseHat\n"
+        "sense=SenseHat()\n"
+        "temp=sense.pressure\n"
+        "f=open(\"tempfileforpython.txt\",\"w\")\n"
+        "f.write(repr(temp))\n"
+        "f.close()\n");
+    double reading = 0;
+    FILE *fp;
+    fp = fopen("tempfileforpython.txt", "r");
+    fscanf(fp, "%lf", &reading);
+    fclose(fp);
+    rd.pressure = reading;
+    rd.temperature = 5; //placeholder, use the temperature from the ht221s
+#else
+    // Degrade to no reading when the sensor is missing
+    if (!ShWait(SHLPS25H))
+    {
+        rd.temperature = rd.pressure = NAN;
+        return rd;
+    }
+
+    rd = ShReadLPS25H(LPS25Hfd);
 #endif
     return rd;
 }
@@ -314,110 +797,14 @@ ht221sData_s ShGetHT221SData(void)
     //fprintf(stdout, "%lf\n", reading);
     rd.humidity = reading;
 #else
-    int status;
-    uint8_t t0_out_l, t0_out_h, t1_out_l, t1_out_h;
-    uint8_t t0_degC_x8, t1_degC_x8, t1_t0_msb;
-    int16_t T0_OUT, T1_OUT;
-    uint16_t T0_DegC_x8, T1_DegC_x8;
-    double T0_DegC, T1_DegC;
-    double t_gradient_m, t_intercept_c;
-    uint8_t t_out_l, t_out_h;
-    int16_t T_OUT;
-    uint8_t h0_out_l, h0_out_h, h1_out_l, h1_out_h, h0_rh_x2, h1_rh_x2, h_t_out_l, h_t_out_h;
-    int16_t H0_T0_OUT, H1_T0_OUT, H_T_OUT;
-    double H0_rH, H1_rH, h_gradient_m, h_intercept_c;
-
-    // Power down the device (clean start)
-    wiringPiI2CWriteReg8(HTS221fd, CTRL_REG1, 0x00);
-    // Turn on the humidity sensor analog front end in single shot mode
-    wiringPiI2CWriteReg8(HTS221fd, CTRL_REG1, 0x84);
-    // Run one-shot measurement (temperature and humidity). The set bit will be reset by the
-    // sensor itself after execution (self-clearing bit)
-    wiringPiI2CWriteReg8(HTS221fd, CTRL_REG2, 0x01);
-
-    // Wait until the measurement is completed
-    do
+    // Degrade to no reading when the sensor is missing
+    if (!ShWait(SHHTS221))
     {
-        usleep(HTS221DELAY); // 25 ms
-        status = wiringPiI2CReadReg8(HTS221fd, CTRL_REG2);
-    } while (status != 0);
-
-    // Read calibration temperature LSB (ADC) data
-    // (temperature calibration x-data for two points)
-    t0_out_l = wiringPiI2CReadReg8(HTS221fd, T0_OUT_L);
-    t0_out_h = wiringPiI2CReadReg8(HTS221fd, T0_OUT_H);
-    t1_out_l = wiringPiI2CReadReg8(HTS221fd, T1_OUT_L);
-    t1_out_h = wiringPiI2CReadReg8(HTS221fd, T1_OUT_H);
-
-    // Read calibration relative humidity LSB (ADC) data
-    // (humidity calibration x-data for two points)
-    h0_out_l = wiringPiI2CReadReg8(HTS221fd, H0_T0_OUT_L);
-    h0_out_h = wiringPiI2CReadReg8(HTS221fd, H0_T0_OUT_H);
-    h1_out_l = wiringPiI2CReadReg8(HTS221fd, H1_T0_OUT_L);
-    h1_out_h = wiringPiI2CReadReg8(HTS221fd, H1_T0_OUT_H);
-
-    // Read calibration temperature (�C) data
-    // (temperature calibration y-data for two points)
-    t0_degC_x8 = wiringPiI2CReadReg8(HTS221fd, T0_degC_x8);
-    t1_degC_x8 = wiringPiI2CReadReg8(HTS221fd, T1_degC_x8);
-    t1_t0_msb = wiringPiI2CReadReg8(HTS221fd, T1_T0_MSB);
-
-    // Read relative humidity (% rH) data
-    // (humidity calibration y-data for two points)
-    h0_rh_x2 = wiringPiI2CReadReg8(HTS221fd, H0_rH_x2);
-    h1_rh_x2 = wiringPiI2CReadReg8(HTS221fd, H1_rH_x2);
-
-    // make 16 bit values (bit shift)
-    // (temperature calibration x-values)
-    T0_OUT = t0_out_h << 8 | t0_out_l;
-    T1_OUT = t1_out_h << 8 | t1_out_l;
-
-    // make 16 and 10 bit values (bit mask and bit shift)
-    T0_DegC_x8 = (t1_t0_msb & 3) << 8 | t0_degC_x8;
-    T1_DegC_x8 = ((t1_t0_msb & 12) >> 2) << 8 | t1_degC_x8;
-
-    // Calculate calibration values
-    // (temperature calibration y-values)
-    T0_DegC = T0_DegC_x8 / 8.0;
-    T1_DegC = T1_DegC_x8 / 8.0;
-
-    // Solve the linear equasions 'y = mx + c' to give the
-    // calibration straight line graphs for temperature and humidity
-    t_gradient_m = (T1_DegC - T0_DegC) / (T1_OUT - T0_OUT);
-    t_intercept_c = T1_DegC - (t_gradient_m * T1_OUT);
-
-    // Read the ambient temperature measurement (2 bytes to read)
-    t_out_l = wiringPiI2CReadReg8(HTS221fd, TEMP_OUT_L);
-    t_out_h = wiringPiI2CReadReg8(HTS221fd, TEMP_OUT_H);
-
-    // make 16 bit value
-    T_OUT = t_out_h << 8 | t_out_l;
-
-    // make 16 bit values (bit shift)
-    // (humidity calibration x-values)
-    H0_T0_OUT = h0_out_h << 8 | h0_out_l;
-    H1_T0_OUT = h1_out_h << 8 | h1_out_l;
-
-    // Humidity calibration values
-    // (humidity calibration y-values)
-    H0_rH = h0_rh_x2 / 2.0;
-    H1_rH = h1_rh_x2 / 2.0;
-    h_gradient_m = (H1_rH - H0_rH) / (H1_T0_OUT - H0_T0_OUT);
-    h_intercept_c = H1_rH - (h_gradient_m * H1_T0_OUT);
-
-    // Read the ambient humidity measurement (2 bytes to read)
-    h_t_out_l = wiringPiI2CReadReg8(HTS221fd, H_T_OUT_L);
-    h_t_out_h = wiringPiI2CReadReg8(HTS221fd, H_T_OUT_H);
-
-    // make 16 bit value
-    H_T_OUT = h_t_out_h << 8 | h_t_out_l;
-
-    // Power down the device
-    wiringPiI2CWriteReg8(HTS221fd, CTRL_REG1, 0x00);
+        rd.temperature = rd.humidity = NAN;
+        return rd;
+    }
 
-    // Calculate and return ambient temperature
-    rd.temperature = (t_gradient_m * T_OUT) + t_intercept_c;
-    rd.humidity = (h_gradient_m * H_T_OUT) + h_intercept_c;
+    rd = ShReadHTS221(HTS221fd);
 #endif
     return rd;
 }
@@ -10,7 +10,10 @@
 #include <fcntl.h>
 #include <linux/fb.h>
 #include <linux/input.h>
+#include <math.h>
 #include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -70,6 +73,16 @@
 #define H_T_OUT_L 0x28
 #define H_T_OUT_H 0x29
 
+// I2C bus the Sensehat sensors sit on
+#define I2CDEVICE "/dev/i2c-1"
+#define I2CSLAVE 0x0703 // I2C_SLAVE ioctl from linux/i2c-dev.h
+#define HTS221WHOAMI 0xBC
+#define LPS25HWHOAMI 0xBD
+
+// Sense Hat Joystick Constants
+#define JOYSTICKDIR "/dev/input"
+#define JOYSTICKNAME "Raspberry Pi Sense HAT Joystick"
+
 // Sense Hat Frame Buffer Constants
 #define FILEPATH "/dev/fb1"
 #define NUM_WORDS 64
@@ -80,6 +93,24 @@
 #define RGB565_GREEN 0x07E0
 #define RGB565_BLUE 0x001F
 
+// Devices probed independently by ShInit
+typedef enum
+{
+    SHMATRIX,
+    SHHTS221,
+    SHLPS25H,
+    SHJOYSTICK,
+    SHDEVICES
+} shdevice_e;
+
+typedef enum
+{
+    SHUNPROBED,
+    SHPROBING,
+    SHPRESENT,
+    SHABSENT
+} shstate_e;
+
 // Structures
 typedef struct fbpixel
 {
@@ -100,15 +131,54 @@ typedef struct ht221sData
   double humidity;
 } ht221sData_s;
 
+// Factory calibration of an HTS221, two points on each line
+typedef struct ht221sCalib
+{
+  int16_t t0out;     // temperature counts at the two points
+  int16_t t1out;
+  uint16_t t0degcx8; // temperature at the two points, eighths of a degree
+  uint16_t t1degcx8;
+  int16_t h0out;     // humidity counts at the two points
+  int16_t h1out;
+  uint8_t h0rhx2;    // humidity at the two points, half percent steps
+  uint8_t h1rhx2;
+} ht221sCalib_s;
+
+// Raw output registers of one measurement
+typedef struct ht221sRaw
+{
+  int16_t tout;
+  int16_t hout;
+} ht221sRaw_s;
+
+typedef struct lps25hRaw
+{
+  int16_t tout;
+  int32_t pout;
+} lps25hRaw_s;
+
 // Function Prototypes
 /// @cond INTERNAL
 int ShInit(void);
 int ShExit(void);
+int ShProbe(shdevice_e dev);
+shstate_e ShState(shdevice_e dev);
+int ShWait(shdevice_e dev);
 void ShClearMatrix(void);
 uint8_t ShSetPixel(int x, int y, fbpixel_s px);
 int ShSetVerticalBar(int bar, fbpixel_s px, uint8_t value);
 double ShLPS25HGetPressure(void);
 lps25hData_s ShGetLPS25HData(void);
 ht221sData_s ShGetHT221SData(void);
+#if !EMULATOR
+int ShOpenSensor(const char *bus, int addr, int whoami);
+int ShReadLPS25HRaw(int fd, lps25hRaw_s *raw);
+lps25hData_s ShConvertLPS25H(lps25hRaw_s raw);
+lps25hData_s ShReadLPS25H(int fd);
+int ShReadHTS221Calib(int fd, ht221sCalib_s *cal);
+int ShReadHTS221Raw(int fd, ht221sRaw_s *raw);
+ht221sData_s ShConvertHTS221(const ht221sCalib_s *cal, ht221sRaw_s raw);
+ht221sData_s ShReadHTS221(int fd);
+#endif
 /// @endcond
 #endif
\ No newline at end of file